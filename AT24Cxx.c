@@ -22,6 +22,26 @@
  *   01-12-2023        iammingge                Initial Version 1.0
  *   18-06-2023        iammingge                1. Support software i2c to drive device
  *											    2. Support hardware i2c to drive device
+ *   18-10-2026        iammingge                1. Add record layout planner
+ *                                              2. Add compile-time record map
+ *                                              3. Add persistent variables
+ *                                              4. Add asynchronous read/write/erase
+ *                                              5. Add static arena for driver buffers
+ *                                              6. Add AT24Cxx_GetDevAddress for port transfers
+ *                                              7. Add open-drain software i2c mode
+ *                                              8. Add multi-lane gang write
+ *                                              9. Configuration macros can be set by the build
+ *                                              10. Fix AT24Cxx_Readback_Write beyond 2550 bytes, 32-bit address and size
+ *                                              11. Add set-associative page cache
+ *                                              12. Add double-buffered shadow for interrupt readers
+ *                                              13. Add lazy write cycle with reads served from the programmed page
+ *                                              14. Add deferred writes flushed at idle time
+ *                                              15. Add write transactions with optional journal
+ *                                              16. Add cancel, transfer budget and verify to asynchronous operations
+ *                                              17. Add write cycle timeouts with bus release
+ *                                              18. Add preload wait on asynchronous reads
+ *                                              19. Add packed boot region of persistent variables
+ *                                              20. Add versioned records with lazy migration
 **/
 
 #include "AT24Cxx.h"
@@ -49,46 +69,217 @@
 #define rbit(val, x)        (((val) & (1<<(x)))>>(x))	    /* Read  1 bit */
 #define min(a, b) 	        (((a) < (b)) ? (a) : (b))       /* Take the minimum value */    
 #define max(a, b)           (((a) > (b)) ? (a) : (b))       /* Take the maximum value */
+
+/* Erase buffer size of hardware i2c */
+#define AT24Cxx_ERASE_BUFSIZE       max(8, AT24Cxx_MAX_ERASE_SIZE)
+
+/* Static arena of the optional subsystem buffers, every slice aligned for any driver struct */
+typedef union
+{
+    void *p;
+    uint64_t u;
+} AT24Cxx_ALIGN_t;
+
+#define AT24Cxx_ALIGN               sizeof(AT24Cxx_ALIGN_t)
+
+static AT24Cxx_ALIGN_t AT24Cxx_Arena[(AT24Cxx_ARENA_SIZE + AT24Cxx_ALIGN - 1) / AT24Cxx_ALIGN];
+static uint32_t AT24Cxx_ArenaUsed = 0;
+static uint32_t AT24Cxx_ArenaNeed = 0;
+
+/* Software i2c bus primitives */
+#if AT24Cxx_I2C_MODE == 0 && AT24Cxx_SW_OPENDRAIN == 1
+#define AT24Cxx_SW_RESET(bus)       AT24Cxx_OD_Reset(bus)
+#define AT24Cxx_SW_STRT(bus)        AT24Cxx_OD_Start(bus)
+#define AT24Cxx_SW_STOP(bus)        AT24Cxx_OD_Stop(bus)
+#define AT24Cxx_SW_WADDR(bus, addr) AT24Cxx_OD_WByte(bus, (uint8_t)((addr) & 0xFE))
+#define AT24Cxx_SW_RADDR(bus, addr) AT24Cxx_OD_WByte(bus, (uint8_t)((addr) | 0x01))
+#define AT24Cxx_SW_WBYTE(bus, byte) AT24Cxx_OD_WByte(bus, byte)
+#define AT24Cxx_SW_RBYTE(bus, ack)  AT24Cxx_OD_RByte(bus, ack)
+#else
+#define AT24Cxx_SW_RESET(bus)       swi2c_reset(bus)
+#define AT24Cxx_SW_STRT(bus)        swi2c_strt(bus)
+#define AT24Cxx_SW_STOP(bus)        swi2c_stop(bus)
+#define AT24Cxx_SW_WADDR(bus, addr) swi2c_waddr(bus, addr)
+#define AT24Cxx_SW_RADDR(bus, addr) swi2c_raddr(bus, addr)
+#define AT24Cxx_SW_WBYTE(bus, byte) swi2c_wbyte(bus, byte)
+#define AT24Cxx_SW_RBYTE(bus, ack)  swi2c_rbyte(bus, ack)
+#endif
 /*------------------------------------------------------*/
-/*                AT24Cxx Basic Function                */
+/*                AT24Cxx Arena Function                */
 /*------------------------------------------------------*/
 /**
- * @brief  AT24Cxx get page One-time write size
- * @param  {at24cxx_t} *dev : device structure pointer
- * @return {uint16_t}       : one page size
- * @note   none
+ * @brief  AT24Cxx allocate driver buffer from the static arena
+ * @param  {uint32_t} size : buffer size (byte)
+ * @return {void *}        : buffer (aligned for pointers and 64-bit integers),
+ *                           NULL --- arena exhausted
+ * @note   Buffers are never freed, allocate at init only
  */
-static uint16_t AT24Cxx_GetPageWriteSize(at24cxx_t *dev)
+void *AT24Cxx_Arena_Alloc(uint32_t size)
 {
-    if (dev->info.type == AT24C01 || \
-        dev->info.type == AT24C02)
-    {
-        return 0x08;  /* One time write <= 8 byte */
-    }
-    else if (dev->info.type == AT24C04 || \
-        dev->info.type == AT24C08 || \
-        dev->info.type == AT24C16)
+    void *buf = NULL;
+
+    /* Keep the next slice aligned */
+    size = (size + AT24Cxx_ALIGN - 1) / AT24Cxx_ALIGN * AT24Cxx_ALIGN;
+    AT24Cxx_ArenaNeed += size;
+
+    if (AT24Cxx_ArenaUsed + size <= sizeof(AT24Cxx_Arena))
     {
-        return 0x10;  /* One time write <= 16 byte */
+        buf = (uint8_t *)AT24Cxx_Arena + AT24Cxx_ArenaUsed;
+        AT24Cxx_ArenaUsed += size;
     }
-    else if (dev->info.type == AT24C32 || \
-        dev->info.type == AT24C64)
+
+    return buf;
+}
+/**
+ * @brief  AT24Cxx report static arena usage
+ * @param  {uint32_t} *used : allocated size (may be NULL)
+ * @param  {uint32_t} *need : requested size including failed requests (may be NULL)
+ * @return {uint32_t}       : arena size (AT24Cxx_ARENA_SIZE rounded up to the alignment)
+ * @note   All buffers are allocated at init, so used is also the worst case.
+ *         need > arena size means some subsystem runs without its buffer.
+ */
+uint32_t AT24Cxx_Arena_Report(uint32_t *used, uint32_t *need)
+{
+    if (used != NULL) *used = AT24Cxx_ArenaUsed;
+    if (need != NULL) *need = AT24Cxx_ArenaNeed;
+
+    return sizeof(AT24Cxx_Arena);
+}
+#if AT24Cxx_I2C_MODE == 0 && AT24Cxx_SW_OPENDRAIN == 1
+/*------------------------------------------------------*/
+/*              AT24Cxx Open-drain Bus Function         */
+/*------------------------------------------------------*/
+/**
+ * @brief  Open-drain i2c start condition
+ * @param  {sw_i2c_t} *bus : software i2c bus pointer
+ * @return none
+ * @note   SCL low on return
+ */
+static void AT24Cxx_OD_Start(sw_i2c_t *bus)
+{
+    bus->set_sda(1);
+    bus->set_scl(1);
+    bus->holdtime(1);
+    bus->set_sda(0);
+    bus->holdtime(1);
+    bus->set_scl(0);
+}
+/**
+ * @brief  Open-drain i2c stop condition
+ * @param  {sw_i2c_t} *bus : software i2c bus pointer
+ * @return none
+ * @note   Bus released (SCL and SDA high) on return
+ */
+static void AT24Cxx_OD_Stop(sw_i2c_t *bus)
+{
+    bus->set_sda(0);
+    bus->holdtime(1);
+    bus->set_scl(1);
+    bus->holdtime(1);
+    bus->set_sda(1);
+    bus->holdtime(1);
+}
+/**
+ * @brief  Open-drain i2c write one byte
+ * @param  {sw_i2c_t} *bus : software i2c bus pointer
+ * @param  {uint8_t} byte  : byte to send (MSB first)
+ * @return {uint8_t}       : 0 --- ACK
+ *                           1 --- NACK
+ * @note   SDA is released (driven high) to read the acknowledge
+ */
+static uint8_t AT24Cxx_OD_WByte(sw_i2c_t *bus, uint8_t byte)
+{
+    uint8_t i, nack;
+
+    for (i = 0; i < 8; i++)
     {
-        return 0x20;  /* One time write <= 32 byte */
+        bus->set_sda((byte & 0x80) ? 1 : 0);
+        byte <<= 1;
+        bus->holdtime(1);
+        bus->set_scl(1);
+        bus->holdtime(1);
+        bus->set_scl(0);
     }
-    else if (dev->info.type == AT24C128 || \
-        dev->info.type == AT24C256)
+
+    /* Acknowledge clock */
+    bus->set_sda(1);
+    bus->holdtime(1);
+    bus->set_scl(1);
+    bus->holdtime(1);
+    nack = bus->get_sda() ? 1 : 0;
+    bus->set_scl(0);
+
+    return nack;
+}
+/**
+ * @brief  Open-drain i2c read one byte
+ * @param  {sw_i2c_t} *bus : software i2c bus pointer
+ * @param  {uint8_t} ack   : ACK --- more bytes follow, NACK --- last byte
+ * @return {uint8_t}       : received byte
+ * @note   SDA is released (driven high) and sampled directly
+ */
+static uint8_t AT24Cxx_OD_RByte(sw_i2c_t *bus, uint8_t ack)
+{
+    uint8_t i, byte = 0;
+
+    bus->set_sda(1);
+    for (i = 0; i < 8; i++)
     {
-        return 0x40;
+        bus->holdtime(1);
+        bus->set_scl(1);
+        bus->holdtime(1);
+        byte = (uint8_t)((byte << 1) | (bus->get_sda() ? 1 : 0));
+        bus->set_scl(0);
     }
-    else if (dev->info.type == AT24C512)
+
+    /* Acknowledge clock */
+    bus->set_sda((ack == ACK) ? 0 : 1);
+    bus->holdtime(1);
+    bus->set_scl(1);
+    bus->holdtime(1);
+    bus->set_scl(0);
+    bus->set_sda(1);
+
+    return byte;
+}
+/**
+ * @brief  Open-drain i2c bus reset
+ * @param  {sw_i2c_t} *bus : software i2c bus pointer
+ * @return none
+ * @note   Nine clocks with SDA released free a slave stuck in a transfer
+ */
+static void AT24Cxx_OD_Reset(sw_i2c_t *bus)
+{
+    uint8_t i;
+
+    bus->set_sda(1);
+    for (i = 0; i < 9; i++)
     {
-        return 0x80;
+        bus->set_scl(0);
+        bus->holdtime(1);
+        bus->set_scl(1);
+        bus->holdtime(1);
     }
-    else if (dev->info.type == AT24CM01 || \
-        dev->info.type == AT24CM02)
+
+    AT24Cxx_OD_Start(bus);
+    AT24Cxx_OD_Stop(bus);
+}
+#endif
+/*------------------------------------------------------*/
+/*                AT24Cxx Basic Function                */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx get page One-time write size
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint16_t}       : one page size
+ * @note   none
+ */
+static uint16_t AT24Cxx_GetPageWriteSize(at24cxx_t *dev)
+{
+    if (dev->info.type >= AT24C01 && \
+        dev->info.type <= AT24CM02)
     {
-        return 0x100;
+        return AT24Cxx_PAGESIZE(dev->info.type);
     }
 
     return 0x08;    /* Default maximum number of bytes written at once */
@@ -109,10 +300,37 @@ void AT24Cxx_config(at24cxx_t *dev, AT24Cxx_CHIP type, uint8_t devaddr, uint8_t
     dev->info.i2caddr.hardaddr.bit = haraddr;
     dev->info.pagesize = AT24Cxx_GetPageWriteSize(dev);
 
+#if AT24Cxx_CACHE_SETS != 0
+
+    /* Page cache is attached by AT24Cxx_Cache_Init */
+    dev->cache = NULL;
+
+#endif
+
+#if AT24Cxx_LAZY_WCYCLE != 0
+
+    /* Lazy write cycle is attached by AT24Cxx_Lazy_Init */
+    dev->pend = NULL;
+
+#endif
+
+#if AT24Cxx_DEFER_PAGES != 0
+
+    /* Staging buffer is attached by AT24Cxx_Defer_Init */
+    dev->defer = NULL;
+
+#endif
+
+#if AT24Cxx_TIMEOUT_MS != 0
+
+    dev->timeout = AT24Cxx_TIMEOUT_MS;
+
+#endif
+
 #if AT24Cxx_I2C_MODE == 0
 
     /* Software reset */
-    swi2c_reset(dev->port.bus);
+    AT24Cxx_SW_RESET(dev->port.bus);
 
 #endif
 }
@@ -165,319 +383,2710 @@ static void AT24Cxx_SetWordAddress(at24cxx_t *dev, uint32_t addr, uint8_t *addrs
     }
 }
 /**
- * @brief  AT24Cxx read memory data
- * @param  {at24cxx_t} *dev : device structure pointer
- * @param  {uint32_t} saddr : start address
- * @param  {uint8_t} *data  : read data pointer
- * @param  {uint32_t} size  : read data size (See the "Byte" column in the 30 line list above)
- * @return {uint8_t}        : 0 --- success
- *                            1 --- error
- * @note   none
+ * @brief  AT24Cxx get i2c device address of a word address
+ * @param  {at24cxx_t} *dev    : device structure pointer
+ * @param  {uint32_t} addr     : word address
+ * @param  {uint8_t} *addrsize : word address size
+ * @return {uint8_t}           : i2c device address (8 bit, block bits included)
+ * @note   For ports that build their own transfers
  */
-uint8_t AT24Cxx_Read(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+uint8_t AT24Cxx_GetDevAddress(at24cxx_t *dev, uint32_t addr, uint8_t *addrsize)
 {
-    uint8_t memaddr_size = 1;
-    uint8_t rsp = 0;
+    AT24Cxx_SetWordAddress(dev, addr, addrsize);
 
-#if AT24Cxx_I2C_MODE == 0
+    return dev->info.i2caddr.byte;
+}
+/**
+ * @brief  AT24Cxx get size of the next program operation
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint32_t} addr    : program address
+ * @param  {uint32_t} remain  : remaining size
+ * @param  {uint8_t} fill     : 0 --- program data, 1 --- program filling data
+ * @return {uint16_t}         : program size (never crosses a page boundary)
+ * @note   none
+ */
+static uint16_t AT24Cxx_ProgramSize(at24cxx_t *dev, uint32_t addr, uint32_t remain, uint8_t fill)
+{
+    /* Get the remaining size of the current page */
+    uint16_t size = dev->info.pagesize - (addr % dev->info.pagesize);
 
-    uint32_t i = 0;
+#if AT24Cxx_I2C_MODE != 0
 
-    /* Set data word address */
-    AT24Cxx_SetWordAddress(dev, saddr, &memaddr_size);
+    /* Filling data is sent from the erase buffer */
+    if (fill) size = min(size, AT24Cxx_ERASE_BUFSIZE);
 
-    /*--------------------------------------------------*/
-    /* IIC start */
-    swi2c_strt(dev->port.bus);
+#else
 
-    /* IIC send i2c address and at24cxx address */
-    if (memaddr_size == 1)
-    {
-        rsp |= swi2c_waddr(dev->port.bus, dev->info.i2caddr.byte);
-        rsp |= swi2c_wbyte(dev->port.bus, LSB_16(saddr));
-    }
-    else
-    {
-        rsp |= swi2c_waddr(dev->port.bus, dev->info.i2caddr.byte);
-        rsp |= swi2c_wbyte(dev->port.bus, MSB_16(saddr));
-        rsp |= swi2c_wbyte(dev->port.bus, LSB_16(saddr));
-    }
-    /*--------------------------------------------------*/
+    (void)fill;
 
-    /*--------------------------------------------------*/
-    /* IIC start */
-    swi2c_strt(dev->port.bus);
+#endif
 
-    /* IIC send i2c address */
-    rsp |= swi2c_raddr(dev->port.bus, dev->info.i2caddr.byte);
+    return (uint16_t)min(remain, size);
+}
+/**
+ * @brief  AT24Cxx CRC-16/CCITT update
+ * @param  {uint16_t} crc        : current crc
+ * @param  {const uint8_t} *data : data pointer
+ * @param  {uint32_t} size       : data size
+ * @return {uint16_t}            : updated crc
+ */
+static uint16_t AT24Cxx_Crc16(uint16_t crc, const uint8_t *data, uint32_t size)
+{
+    uint8_t i;
 
-    /* IIC send read data to memory */
-    for (i = 0; i < size - 1; i++)
+    while (size--)
     {
-        data[i] = swi2c_rbyte(dev->port.bus, ACK);
+        crc ^= (uint16_t)(*data++) << 8;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
     }
-    data[i] = swi2c_rbyte(dev->port.bus, NACK);
 
-    /* IIC stop */
-    swi2c_stop(dev->port.bus);
-    /*--------------------------------------------------*/
+    return crc;
+}
+#if AT24Cxx_LAZY_WCYCLE != 0 || AT24Cxx_ASYNC_ACKPOLL != 0 || AT24Cxx_TIMEOUT_MS != 0
+/**
+ * @brief  AT24Cxx acknowledge polling
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint8_t}        : 0 --- device ready
+ *                            1 --- device busy (self-timed write cycle) or absent
+ * @note   Hardware bus : send() with size 0 must only address the device
+ */
+static uint8_t AT24Cxx_AckPoll(at24cxx_t *dev)
+{
+    uint8_t rsp = 0;
 
-#else
+#if AT24Cxx_I2C_MODE == 0
 
-    /* Set data word address */
-    AT24Cxx_SetWordAddress(dev, saddr, &memaddr_size);
+    /* IIC start, send i2c address, IIC stop */
+    AT24Cxx_SW_STRT(dev->port.bus);
+    rsp = AT24Cxx_SW_WADDR(dev->port.bus, dev->info.i2caddr.byte);
+    AT24Cxx_SW_STOP(dev->port.bus);
+
+#else
 
-    /* Read data */
-    rsp = dev->port.bus->rmem(dev->info.i2caddr.byte, saddr, memaddr_size, data, size);
+    rsp = dev->port.bus->send(dev->info.i2caddr.byte, NULL, 0);
 
 #endif
 
     return rsp;
 }
+#endif
+#if AT24Cxx_TIMEOUT_MS != 0
+/**
+ * @brief  AT24Cxx set write cycle timeout
+ * @param  {at24cxx_t} *dev : device structure pointer (configured)
+ * @param  {uint16_t} ms    : timeout (ms), longest write cycle of the chip plus margin
+ * @return none
+ * @note   AT24Cxx_config sets AT24Cxx_TIMEOUT_MS
+ */
+void AT24Cxx_SetTimeout(at24cxx_t *dev, uint16_t ms)
+{
+    dev->timeout = ms;
+}
 /**
- * @brief  AT24Cxx write memory data
+ * @brief  AT24Cxx check device timeout
  * @param  {at24cxx_t} *dev : device structure pointer
- * @param  {uint32_t} saddr : start address
- * @param  {uint8_t} *data  : write data pointer
- * @param  {uint32_t} size  : write data size (See the "Byte" column in the 30 line list above)
- * @return {uint8_t}        : 0 --- success
- *                            1 --- error
- * @note   none
+ * @param  {uint32_t} start : tick the wait started
+ * @return {uint8_t}        : 0 --- in time
+ *                            1 --- expired
  */
-uint8_t AT24Cxx_Write(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+static uint8_t AT24Cxx_Expired(at24cxx_t *dev, uint32_t start)
+{
+    return (uint64_t)(uint32_t)(AT24CXX_GETTICK() - start) * 1000 >= (uint64_t)dev->timeout * AT24Cxx_TICK_FREQ;
+}
+/**
+ * @brief  AT24Cxx release the bus after a timeout
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return none
+ * @note   Software bus : nine clocks and a stop condition
+ */
+static void AT24Cxx_Release(at24cxx_t *dev)
 {
-    uint32_t i = 0;
-    uint32_t RemainSize = size;
-    uint32_t EndAddr = saddr + size;
-    uint16_t CurPageSize = 0;
-    uint8_t memaddr_size = 1;
-    uint8_t rsp = 0;
-
 #if AT24Cxx_I2C_MODE == 0
 
-    uint16_t j = 0;
+    AT24Cxx_SW_RESET(dev->port.bus);
 
-    for (i = saddr; i < EndAddr; i += size)
-    {
-        /* Get the remaining size of the current page */
-        CurPageSize = dev->info.pagesize - (i % dev->info.pagesize);
+#else
 
-        /* Current write size, Update remaining size */
-        size = min(RemainSize, CurPageSize);
-        RemainSize -= size;
+    AT24CXX_HW_RELEASE(dev->port.bus);
 
-        /* Set data word address */
-        AT24Cxx_SetWordAddress(dev, i, &memaddr_size);
+#endif
+}
+#endif
+/**
+ * @brief  AT24Cxx wait until the self-timed write cycle is over
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint8_t}        : 0 --- success
+ *                            2 --- timeout (device busy or absent)
+ * @note   Acknowledge polling bounded by the device timeout, or the fixed delay
+ */
+static uint8_t AT24Cxx_Wait(at24cxx_t *dev)
+{
+#if AT24Cxx_TIMEOUT_MS != 0
 
-        /*--------------------------------------------------*/
-        /* IIC start */
-        swi2c_strt(dev->port.bus);
+    uint32_t start = AT24CXX_GETTICK();
 
-        /* IIC send i2c address and at24cxx address */
-        if (memaddr_size == 1)
-        {
-            rsp |= swi2c_waddr(dev->port.bus, dev->info.i2caddr.byte);
-            rsp |= swi2c_wbyte(dev->port.bus, LSB_16(i));
-        }
-        else
+    while (AT24Cxx_AckPoll(dev))
+    {
+        if (AT24Cxx_Expired(dev, start))
         {
-            rsp |= swi2c_waddr(dev->port.bus, dev->info.i2caddr.byte);
-            rsp |= swi2c_wbyte(dev->port.bus, MSB_16(i));
-            rsp |= swi2c_wbyte(dev->port.bus, LSB_16(i));
+            AT24Cxx_Release(dev);
+            return AT24Cxx_ETIMEOUT;
         }
+    }
 
-        /*  IIC send write data to memory */
-        for (j = 0; j < size; j++)
-        {
-            rsp |= swi2c_wbyte(dev->port.bus, *(data++));
-        }
+#else
 
-        /* IIC stop */
-        swi2c_stop(dev->port.bus);
-        /*--------------------------------------------------*/
+    (void)dev;
+    AT24CXX_WCYCLEMS;
 
-        /* Self-timed Write cycle */
-        AT24CXX_WCYCLEMS;
-    }
+#endif
 
-#else
+    return 0;
+}
+#if AT24Cxx_LAZY_WCYCLE != 0
+/**
+ * @brief  AT24Cxx finish a pending write cycle
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint8_t}        : 0 --- success
+ *                            2 --- timeout
+ * @note   One acknowledge poll, the full write cycle wait only if the device is still busy
+ */
+static uint8_t AT24Cxx_Settle(at24cxx_t *dev)
+{
+    if (dev->pend == NULL || !dev->pend->busy) return 0;
 
-    for (i = saddr; i < EndAddr; i += size)
+    dev->pend->busy = 0;
+    if (AT24Cxx_AckPoll(dev)) return AT24Cxx_Wait(dev);
+
+    return 0;
+}
+#endif
+#if AT24Cxx_CACHE_SETS != 0
+/**
+ * @brief  AT24Cxx find cache line of a page
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} page  : page number
+ * @return {int32_t}        : line index, -1 --- not cached
+ * @note   none
+ */
+static int32_t AT24Cxx_Cache_Find(at24cxx_t *dev, uint32_t page)
+{
+    uint32_t i = (page % AT24Cxx_CACHE_SETS) * AT24Cxx_CACHE_WAYS;
+    uint32_t end = i + AT24Cxx_CACHE_WAYS;
+
+    for (; i < end; i++)
     {
-        /* Get the remaining size of the current page */
-        CurPageSize = dev->info.pagesize - (i % dev->info.pagesize);
+        if (dev->cache->tag[i] == page + 1) return (int32_t)i;
+    }
 
-        /* Current write size, Update remaining size */
-        size = min(RemainSize, CurPageSize);
-        RemainSize -= size;
+    return -1;
+}
+/**
+ * @brief  AT24Cxx apply a page program to the cache
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} addr  : program address
+ * @param  {uint8_t} *data  : program data (NULL : filling data)
+ * @param  {uint8_t} fdata  : filling data
+ * @param  {uint16_t} size  : program size (within one page)
+ * @param  {uint8_t} rsp    : program result, a failed program drops the line
+ * @return none
+ * @note   Write-through without allocation
+ */
+static void AT24Cxx_Cache_Program(at24cxx_t *dev, uint32_t addr, const uint8_t *data, uint8_t fdata, uint16_t size, uint8_t rsp)
+{
+    int32_t way;
+    uint8_t *line;
 
-        /* Set data word address */
-        AT24Cxx_SetWordAddress(dev, i, &memaddr_size);
+    if (dev->cache == NULL) return;
 
-        /* Write data */
-        rsp = dev->port.bus->wmem(dev->info.i2caddr.byte, i, memaddr_size, data, size);
-        data += size;
+    way = AT24Cxx_Cache_Find(dev, addr / dev->info.pagesize);
+    if (way < 0) return;
 
-        /* Self-timed Write cycle */
-        AT24CXX_WCYCLEMS;
+    if (rsp)
+    {
+        dev->cache->tag[way] = 0;
+        return;
     }
 
-#endif
-
-    return rsp;
+    line = dev->cache->line + (uint32_t)way * dev->info.pagesize + addr % dev->info.pagesize;
+    if (data != NULL) memcpy(line, data, size);
+    else memset(line, fdata, size);
 }
+#endif
 /**
- * @brief  AT24Cxx erase memory data
+ * @brief  AT24Cxx program one page (without waiting for the write cycle)
  * @param  {at24cxx_t} *dev : device structure pointer
- * @param  {uint32_t} saddr : start address
+ * @param  {uint32_t} addr  : program address
+ * @param  {uint8_t} *data  : write data pointer (NULL : program filling data)
  * @param  {uint8_t} fdata  : filling data (0x00 - 0xFF)
- * @param  {uint32_t} size  : erase data size (See the "Byte" column in the 30 line list above)
+ * @param  {uint16_t} size  : program size (See AT24Cxx_ProgramSize)
  * @return {uint8_t}        : 0 --- success
  *                            1 --- error
  * @note   none
  */
-uint8_t AT24Cxx_Erase(at24cxx_t *dev, uint32_t saddr, uint8_t fdata, uint32_t size)
+static uint8_t AT24Cxx_Program(at24cxx_t *dev, uint32_t addr, const uint8_t *data, uint8_t fdata, uint16_t size)
 {
-    uint32_t i = 0;
-    uint32_t RemainSize = size;
-    uint32_t EndAddr = saddr + size;
-    uint16_t CurPageSize = 0;
     uint8_t memaddr_size = 1;
     uint8_t rsp = 0;
 
-#if AT24Cxx_I2C_MODE == 0
+#if AT24Cxx_CACHE_SETS != 0 || AT24Cxx_LAZY_WCYCLE != 0
 
-    uint16_t j = 0;
+    const uint8_t *src = data;
 
-    for (i = saddr; i < EndAddr; i += size)
-    {
-        /* Get the remaining size of the current page */
-        CurPageSize = dev->info.pagesize - (i % dev->info.pagesize);
+#endif
 
-        /* Current write size, Update remaining size */
-        size = min(RemainSize, CurPageSize);
-        RemainSize -= size;
+#if AT24Cxx_LAZY_WCYCLE != 0
 
-        /* Set data word address */
-        AT24Cxx_SetWordAddress(dev, i, &memaddr_size);
+    /* Previous write cycle must be over */
+    rsp = AT24Cxx_Settle(dev);
+    if (rsp != 0) return rsp;
 
-        /*--------------------------------------------------*/
-        /* IIC start */
-        swi2c_strt(dev->port.bus);
+#endif
 
-        /* IIC send i2c address and at24cxx address */
-        if (memaddr_size == 1)
-        {
-            rsp |= swi2c_waddr(dev->port.bus, dev->info.i2caddr.byte);
-            rsp |= swi2c_wbyte(dev->port.bus, LSB_16(i));
-        }
-        else
-        {
-            rsp |= swi2c_waddr(dev->port.bus, dev->info.i2caddr.byte);
-            rsp |= swi2c_wbyte(dev->port.bus, MSB_16(i));
-            rsp |= swi2c_wbyte(dev->port.bus, LSB_16(i));
-        }
+#if AT24Cxx_I2C_MODE == 0
 
-        /*  IIC send write data to memory */
-        for (j = 0; j < size; j++)
-        {
-            rsp |= swi2c_wbyte(dev->port.bus, fdata);
-        }
+    uint16_t j = 0;
+
+    /* Set data word address */
+    AT24Cxx_SetWordAddress(dev, addr, &memaddr_size);
 
-        /* IIC stop */
-        swi2c_stop(dev->port.bus);
-        /*--------------------------------------------------*/
+    /*--------------------------------------------------*/
+    /* IIC start */
+    AT24Cxx_SW_STRT(dev->port.bus);
 
-        /* Self-timed Write cycle */
-        AT24CXX_WCYCLEMS;
+    /* IIC send i2c address and at24cxx address */
+    if (memaddr_size == 1)
+    {
+        rsp |= AT24Cxx_SW_WADDR(dev->port.bus, dev->info.i2caddr.byte);
+        rsp |= AT24Cxx_SW_WBYTE(dev->port.bus, LSB_16(addr));
+    }
+    else
+    {
+        rsp |= AT24Cxx_SW_WADDR(dev->port.bus, dev->info.i2caddr.byte);
+        rsp |= AT24Cxx_SW_WBYTE(dev->port.bus, MSB_16(addr));
+        rsp |= AT24Cxx_SW_WBYTE(dev->port.bus, LSB_16(addr));
+    }
+
+    /*  IIC send write data to memory */
+    for (j = 0; j < size; j++)
+    {
+        rsp |= AT24Cxx_SW_WBYTE(dev->port.bus, (data != NULL) ? *(data++) : fdata);
     }
 
+    /* IIC stop */
+    AT24Cxx_SW_STOP(dev->port.bus);
+    /*--------------------------------------------------*/
+
 #else
 
-    uint16_t erase_size = max(8, AT24Cxx_MAX_ERASE_SIZE);
-	uint8_t fbuf[erase_size];
-	
-    /* Get the maximum erase size allowed */
-    erase_size = min(erase_size, dev->info.pagesize);
+    uint8_t fbuf[AT24Cxx_ERASE_BUFSIZE];
 
     /* Format erase buffer area */
-    memset(fbuf, fdata, erase_size);
+    if (data == NULL)
+    {
+        memset(fbuf, fdata, size);
+        data = fbuf;
+    }
 
-    for (i = saddr; i < EndAddr; i += size)
+    /* Set data word address */
+    AT24Cxx_SetWordAddress(dev, addr, &memaddr_size);
+
+    /* Write data */
+    rsp = dev->port.bus->wmem(dev->info.i2caddr.byte, addr, memaddr_size, (uint8_t *)data, size);
+
+#endif
+
+#if AT24Cxx_CACHE_SETS != 0
+
+    /* Keep cached page coherent */
+    AT24Cxx_Cache_Program(dev, addr, src, fdata, size, rsp);
+
+#endif
+
+#if AT24Cxx_LAZY_WCYCLE != 0
+
+    /* Programmed bytes serve reads during the write cycle */
+    if (dev->pend != NULL)
     {
-        /* Get the remaining size of the current page */
-        CurPageSize = erase_size - (i % erase_size);
+        dev->pend->busy = 1;
+        dev->pend->addr = addr;
+        dev->pend->size = rsp ? 0 : size;
+        if (src != NULL) memcpy(dev->pend->data, src, dev->pend->size);
+        else memset(dev->pend->data, fdata, dev->pend->size);
+    }
 
-        /* Current write size, Update remaining size */
-        size = min(RemainSize, CurPageSize);
-        RemainSize -= size;
+#endif
+
+    return rsp;
+}
+/**
+ * @brief  AT24Cxx wait for the self-timed write cycle
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint8_t}        : 0 --- success
+ *                            2 --- timeout
+ * @note   With AT24Cxx_Lazy_Init the wait is left to the next access of the device
+ */
+static uint8_t AT24Cxx_WriteCycle(at24cxx_t *dev)
+{
+#if AT24Cxx_LAZY_WCYCLE != 0
+
+    if (dev->pend != NULL) return 0;
+
+#endif
+
+    return AT24Cxx_Wait(dev);
+}
+/**
+ * @brief  AT24Cxx read memory data from the device
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} saddr : start address
+ * @param  {uint8_t} *data  : read data pointer
+ * @param  {uint32_t} size  : read data size
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ * @note   One sequential read, the page cache is bypassed. With a pending write
+ *         cycle, reads of the programmed bytes are served from RAM, others wait.
+ */
+static uint8_t AT24Cxx_Fetch(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+{
+    uint8_t memaddr_size = 1;
+    uint8_t rsp = 0;
+
+    if (size == 0) return 0;
+
+#if AT24Cxx_LAZY_WCYCLE != 0
+
+    /* Reads inside the bytes being programmed do not wait for the write cycle */
+    if (dev->pend != NULL && dev->pend->busy)
+    {
+        if (saddr >= dev->pend->addr && saddr + size <= dev->pend->addr + dev->pend->size)
+        {
+            memcpy(data, dev->pend->data + (saddr - dev->pend->addr), size);
+            return 0;
+        }
+        rsp = AT24Cxx_Settle(dev);
+        if (rsp != 0) return rsp;
+    }
+
+#endif
+
+#if AT24Cxx_I2C_MODE == 0
+
+    uint32_t i = 0;
+
+    /* Set data word address */
+    AT24Cxx_SetWordAddress(dev, saddr, &memaddr_size);
+
+    /*--------------------------------------------------*/
+    /* IIC start */
+    AT24Cxx_SW_STRT(dev->port.bus);
+
+    /* IIC send i2c address and at24cxx address */
+    if (memaddr_size == 1)
+    {
+        rsp |= AT24Cxx_SW_WADDR(dev->port.bus, dev->info.i2caddr.byte);
+        rsp |= AT24Cxx_SW_WBYTE(dev->port.bus, LSB_16(saddr));
+    }
+    else
+    {
+        rsp |= AT24Cxx_SW_WADDR(dev->port.bus, dev->info.i2caddr.byte);
+        rsp |= AT24Cxx_SW_WBYTE(dev->port.bus, MSB_16(saddr));
+        rsp |= AT24Cxx_SW_WBYTE(dev->port.bus, LSB_16(saddr));
+    }
+    /*--------------------------------------------------*/
+
+    /*--------------------------------------------------*/
+    /* IIC start */
+    AT24Cxx_SW_STRT(dev->port.bus);
+
+    /* IIC send i2c address */
+    rsp |= AT24Cxx_SW_RADDR(dev->port.bus, dev->info.i2caddr.byte);
+
+    /* IIC send read data to memory */
+    for (i = 0; i < size - 1; i++)
+    {
+        data[i] = AT24Cxx_SW_RBYTE(dev->port.bus, ACK);
+    }
+    data[i] = AT24Cxx_SW_RBYTE(dev->port.bus, NACK);
+
+    /* IIC stop */
+    AT24Cxx_SW_STOP(dev->port.bus);
+    /*--------------------------------------------------*/
+
+#else
+
+    uint32_t span, len;
 
+    /* Read data, split at the blocks of the device address so a port never carries into it */
+    while (size > 0 && rsp == 0)
+    {
         /* Set data word address */
-        AT24Cxx_SetWordAddress(dev, i, &memaddr_size);
+        AT24Cxx_SetWordAddress(dev, saddr, &memaddr_size);
+        span = 1UL << (8 * memaddr_size);
+        len = min(size, span - (saddr & (span - 1)));
 
-        /* Write data */
-        rsp = dev->port.bus->wmem(dev->info.i2caddr.byte, i, memaddr_size, fbuf, size);
+        rsp = dev->port.bus->rmem(dev->info.i2caddr.byte, saddr, memaddr_size, data, len);
 
-        /* Self-timed Write cycle */
-        AT24CXX_WCYCLEMS;
+        saddr += len;
+        data += len;
+        size -= len;
     }
 
 #endif
 
     return rsp;
 }
-/*------------------------------------------------------*/
-/*             AT24Cxx Application Function             */
-/*------------------------------------------------------*/
+#if AT24Cxx_CACHE_SETS != 0
 /**
- * @brief  AT24Cxx Write data and read back for verification
+ * @brief  AT24Cxx read memory data through the page cache
  * @param  {at24cxx_t} *dev : device structure pointer
- * @param  {uint16_t} addr  : start address
- * @param  {uint8_t} *data  : write data pointer
- * @param  {uint16_t} size  : write data size (See the "Byte" column in the 30 line list above)
+ * @param  {uint32_t} saddr : start address
+ * @param  {uint8_t} *data  : read data pointer
+ * @param  {uint32_t} size  : read data size
  * @return {uint8_t}        : 0 --- success
  *                            1 --- error
- * @note   none
+ * @note   Missing pages are read whole into the LRU line of their set.
+ *         Reads larger than the cache bypass it.
  */
-uint8_t AT24Cxx_Readback_Write(at24cxx_t *dev, uint16_t addr, uint8_t *data, uint16_t size)
+static uint8_t AT24Cxx_Cache_Read(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
 {
-    uint8_t i, j;
-    uint8_t compare_data[AT24Cxx_MAX_COMPARE_SIZE];
-    uint8_t remainder;
-    uint16_t quotient;
-    uint16_t point = 0;
+    AT24Cxx_CACHE_t *cache = dev->cache;
+    uint32_t page, offset, len, base, i, victim;
+    int32_t way;
+    uint8_t rsp;
 
-    /* write Data */
-    AT24Cxx_Write(dev, addr, data, size);
+    if (cache != NULL && size <= (uint32_t)AT24Cxx_CACHE_SETS * AT24Cxx_CACHE_WAYS * dev->info.pagesize)
+    {
+        while (size > 0)
+        {
+            page = saddr / dev->info.pagesize;
+            offset = saddr % dev->info.pagesize;
+            len = min(size, dev->info.pagesize - offset);
+
+            way = AT24Cxx_Cache_Find(dev, page);
+            if (way >= 0)
+            {
+                cache->hits++;
+            }
+            else
+            {
+                /* Victim : invalid line first, then least recently used */
+                base = (page % AT24Cxx_CACHE_SETS) * AT24Cxx_CACHE_WAYS;
+                for (victim = i = base; i < base + AT24Cxx_CACHE_WAYS; i++)
+                {
+                    if (cache->tag[i] == 0)
+                    {
+                        victim = i;
+                        break;
+                    }
+                    if (cache->use[i] < cache->use[victim]) victim = i;
+                }
+                way = (int32_t)victim;
+
+                cache->misses++;
+                cache->tag[way] = 0;
+                rsp = AT24Cxx_Fetch(dev, page * dev->info.pagesize, cache->line + (uint32_t)way * dev->info.pagesize, dev->info.pagesize);
+                if (rsp != 0) return rsp;
+                cache->tag[way] = page + 1;
+            }
+            cache->use[way] = ++cache->clock;
+
+            memcpy(data, cache->line + (uint32_t)way * dev->info.pagesize + offset, len);
+            data += len;
+            saddr += len;
+            size -= len;
+        }
+
+        return 0;
+    }
+
+    if (cache != NULL) cache->misses += (size + dev->info.pagesize - 1) / dev->info.pagesize;
+
+    return AT24Cxx_Fetch(dev, saddr, data, size);
+}
+#endif
+#if AT24Cxx_DEFER_PAGES != 0
+/**
+ * @brief  AT24Cxx test staged byte
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} slot  : staging slot
+ * @param  {uint32_t} off   : offset in the page
+ * @return {uint8_t}        : 1 --- byte is staged
+ */
+static uint8_t AT24Cxx_Defer_Dirty(at24cxx_t *dev, uint32_t slot, uint32_t off)
+{
+    return (dev->defer->dirty[slot * AT24Cxx_DEFER_MAPSIZE + off / 8] >> (off % 8)) & 1;
+}
+/**
+ * @brief  AT24Cxx copy staged bytes over read data
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} saddr : start address
+ * @param  {uint8_t} *data  : read data pointer
+ * @param  {uint32_t} size  : read data size
+ * @return none
+ * @note   Staged bytes are newer than the memory
+ */
+static void AT24Cxx_Defer_Overlay(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+{
+    AT24Cxx_DEFER_t *defer = dev->defer;
+    uint32_t slot, base, off, end;
+
+    for (slot = 0; slot < AT24Cxx_DEFER_PAGES; slot++)
+    {
+        if (defer->tag[slot] == 0) continue;
+
+        base = (defer->tag[slot] - 1) * dev->info.pagesize;
+        if (base >= saddr + size || base + dev->info.pagesize <= saddr) continue;
+
+        off = (saddr > base) ? saddr - base : 0;
+        end = min(dev->info.pagesize, saddr + size - base);
+        for (; off < end; off++)
+        {
+            if (AT24Cxx_Defer_Dirty(dev, slot, off)) data[base + off - saddr] = defer->data[slot * dev->info.pagesize + off];
+        }
+    }
+}
+/**
+ * @brief  AT24Cxx drop staged bytes of a range
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} saddr : start address
+ * @param  {uint32_t} size  : range size
+ * @return none
+ * @note   For programs that bypass the staging buffer, their data is newer
+ */
+static void AT24Cxx_Defer_Drop(at24cxx_t *dev, uint32_t saddr, uint32_t size)
+{
+    AT24Cxx_DEFER_t *defer = dev->defer;
+    uint32_t slot, base, off, end, i;
+    uint8_t *map;
 
-    /* calulate quotient and remainder of copies */
-    quotient = size / AT24Cxx_MAX_COMPARE_SIZE;
-    remainder = size % AT24Cxx_MAX_COMPARE_SIZE;
+    if (defer == NULL) return;
 
-    /* compare quotient of copies */
-    for (i = 0; i < quotient; i++)
+    for (slot = 0; slot < AT24Cxx_DEFER_PAGES; slot++)
     {
-        point = i * AT24Cxx_MAX_COMPARE_SIZE;
-        AT24Cxx_Read(dev, addr + point, compare_data, AT24Cxx_MAX_COMPARE_SIZE);
-        for (j = 0; j < AT24Cxx_MAX_COMPARE_SIZE; j++)
+        if (defer->tag[slot] == 0) continue;
+
+        base = (defer->tag[slot] - 1) * dev->info.pagesize;
+        if (base >= saddr + size || base + dev->info.pagesize <= saddr) continue;
+
+        map = defer->dirty + slot * AT24Cxx_DEFER_MAPSIZE;
+        off = (saddr > base) ? saddr - base : 0;
+        end = min(dev->info.pagesize, saddr + size - base);
+        for (; off < end; off++)
         {
-            if (data[point + j] != compare_data[j]) return 1;
+            map[off / 8] &= (uint8_t)~(1 << (off % 8));
+        }
+
+        /* Free the slot when nothing is left */
+        for (i = 0; i < AT24Cxx_DEFER_MAPSIZE && map[i] == 0; i++);
+        if (i == AT24Cxx_DEFER_MAPSIZE) defer->tag[slot] = 0;
+    }
+}
+/**
+ * @brief  AT24Cxx get program span of a staging slot
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} slot  : staging slot
+ * @param  {uint32_t} *lo   : first byte of the span (page offset)
+ * @param  {uint32_t} *hi   : end of the span (page offset)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ * @note   Unstaged bytes between the first and the last staged byte are read
+ *         from the memory and marked staged, so the page costs one program.
+ */
+static uint8_t AT24Cxx_Defer_Span(at24cxx_t *dev, uint32_t slot, uint32_t *lo, uint32_t *hi)
+{
+    AT24Cxx_DEFER_t *defer = dev->defer;
+    uint32_t base = (defer->tag[slot] - 1) * dev->info.pagesize;
+    uint8_t *line = defer->data + slot * dev->info.pagesize;
+    uint8_t *map = defer->dirty + slot * AT24Cxx_DEFER_MAPSIZE;
+    uint32_t off, run, i;
+
+    for (*lo = 0; *lo < dev->info.pagesize && !AT24Cxx_Defer_Dirty(dev, slot, *lo); (*lo)++);
+    for (*hi = dev->info.pagesize; *hi > *lo && !AT24Cxx_Defer_Dirty(dev, slot, *hi - 1); (*hi)--);
+
+    /* Fill the gaps */
+    for (off = *lo; off < *hi; off += run)
+    {
+        for (run = 0; off + run < *hi && !AT24Cxx_Defer_Dirty(dev, slot, off + run); run++);
+        if (run == 0)
+        {
+            run = 1;
+            continue;
+        }
+        if (AT24Cxx_Fetch(dev, base + off, line + off, run)) return 1;
+        for (i = off; i < off + run; i++)
+        {
+            map[i / 8] |= (uint8_t)(1 << (i % 8));
         }
     }
 
-    /* compare quotient of copies */
-    if (quotient > 0)
+    return 0;
+}
+/**
+ * @brief  AT24Cxx program one staging slot
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} slot  : staging slot
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error (the slot stays staged)
+ * @note   One page program
+ */
+static uint8_t AT24Cxx_Defer_Program(at24cxx_t *dev, uint32_t slot)
+{
+    AT24Cxx_DEFER_t *defer = dev->defer;
+    uint32_t base = (defer->tag[slot] - 1) * dev->info.pagesize;
+    uint8_t *line = defer->data + slot * dev->info.pagesize;
+    uint32_t lo, hi;
+
+    if (AT24Cxx_Defer_Span(dev, slot, &lo, &hi)) return 1;
+
+    if (hi > lo)
+    {
+        if (AT24Cxx_Program(dev, base + lo, line + lo, 0, (uint16_t)(hi - lo))) return 1;
+        if (AT24Cxx_WriteCycle(dev)) return AT24Cxx_ETIMEOUT;
+    }
+
+    defer->tag[slot] = 0;
+    memset(defer->dirty + slot * AT24Cxx_DEFER_MAPSIZE, 0, AT24Cxx_DEFER_MAPSIZE);
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx stage write data
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} saddr : start address
+ * @param  {uint8_t} *data  : write data pointer (NULL : filling data)
+ * @param  {uint8_t} fdata  : filling data
+ * @param  {uint32_t} size  : write data size
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error (a slot had to be programmed and failed,
+ *                                  or a transaction ran out of slots)
+ * @note   Slots older than the latency bound are programmed first. A write to a
+ *         new page with all slots in use programs the oldest slot. Nothing is
+ *         programmed inside a transaction.
+ */
+static uint8_t AT24Cxx_Defer_Stage(at24cxx_t *dev, uint32_t saddr, const uint8_t *data, uint8_t fdata, uint32_t size)
+{
+    AT24Cxx_DEFER_t *defer = dev->defer;
+    uint32_t now = AT24CXX_GETTICK();
+    uint32_t page, off, len, slot, victim, i;
+    uint8_t *map;
+
+    for (slot = 0; slot < AT24Cxx_DEFER_PAGES && !defer->txn; slot++)
     {
-        point = i * AT24Cxx_MAX_COMPARE_SIZE;
+        if (defer->tag[slot] != 0 && now - defer->stamp[slot] >= AT24Cxx_DEFER_LATENCY)
+        {
+            if (AT24Cxx_Defer_Program(dev, slot)) return 1;
+        }
     }
-    AT24Cxx_Read(dev, addr + point, compare_data, remainder);
-    for (j = 0; j < remainder; j++)
+
+    while (size > 0)
     {
-        if (data[point + j] != compare_data[j]) return 1;
+        page = saddr / dev->info.pagesize;
+        off = saddr % dev->info.pagesize;
+        len = min(size, dev->info.pagesize - off);
+
+        for (slot = 0; slot < AT24Cxx_DEFER_PAGES && defer->tag[slot] != page + 1; slot++);
+        if (slot == AT24Cxx_DEFER_PAGES)
+        {
+            /* Free slot, or the oldest one programmed now */
+            for (victim = slot = 0; slot < AT24Cxx_DEFER_PAGES && defer->tag[slot] != 0; slot++)
+            {
+                if (now - defer->stamp[slot] > now - defer->stamp[victim]) victim = slot;
+            }
+            if (slot == AT24Cxx_DEFER_PAGES)
+            {
+                slot = victim;
+                if (defer->txn || AT24Cxx_Defer_Program(dev, slot)) return 1;
+            }
+            defer->tag[slot] = page + 1;
+            defer->stamp[slot] = now;
+        }
+
+        if (data != NULL) memcpy(defer->data + slot * dev->info.pagesize + off, data, len);
+        else memset(defer->data + slot * dev->info.pagesize + off, fdata, len);
+        map = defer->dirty + slot * AT24Cxx_DEFER_MAPSIZE;
+        for (i = off; i < off + len; i++)
+        {
+            map[i / 8] |= (uint8_t)(1 << (i % 8));
+        }
+
+        if (data != NULL) data += len;
+        saddr += len;
+        size -= len;
     }
 
     return 0;
 }
+#endif
+/**
+ * @brief  AT24Cxx read memory data
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} saddr : start address
+ * @param  {uint8_t} *data  : read data pointer
+ * @param  {uint32_t} size  : read data size (See the "Byte" column in the 30 line list above)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ *                            2 --- timeout (AT24Cxx_TIMEOUT_MS)
+ * @note   Served through the page cache and the staging buffer when attached
+ */
+uint8_t AT24Cxx_Read(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+{
+    uint8_t rsp;
+
+#if AT24Cxx_CACHE_SETS != 0
+
+    rsp = AT24Cxx_Cache_Read(dev, saddr, data, size);
+
+#else
+
+    rsp = AT24Cxx_Fetch(dev, saddr, data, size);
+
+#endif
+
+#if AT24Cxx_DEFER_PAGES != 0
+
+    if (rsp == 0 && dev->defer != NULL) AT24Cxx_Defer_Overlay(dev, saddr, data, size);
+
+#endif
+
+    return rsp;
+}
+/**
+ * @brief  AT24Cxx write memory data
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} saddr : start address
+ * @param  {uint8_t} *data  : write data pointer
+ * @param  {uint32_t} size  : write data size (See the "Byte" column in the 30 line list above)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ *                            2 --- timeout (AT24Cxx_TIMEOUT_MS)
+ * @note   With a staging buffer, writes up to its size return after the copy
+ */
+uint8_t AT24Cxx_Write(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+{
+    uint32_t i = 0;
+    uint32_t RemainSize = size;
+    uint32_t EndAddr = saddr + size;
+    uint8_t rsp = 0;
+
+#if AT24Cxx_DEFER_PAGES != 0
+
+    /* Small writes are staged, larger ones replace staged bytes */
+    if (dev->defer != NULL)
+    {
+        if (size <= (uint32_t)AT24Cxx_DEFER_PAGES * dev->info.pagesize) return AT24Cxx_Defer_Stage(dev, saddr, data, 0, size);
+        if (dev->defer->txn) return 1;
+        AT24Cxx_Defer_Drop(dev, saddr, size);
+    }
+
+#endif
+
+    for (i = saddr; i < EndAddr; i += size)
+    {
+        /* Current write size, Update remaining size */
+        size = AT24Cxx_ProgramSize(dev, i, RemainSize, 0);
+        RemainSize -= size;
+
+        /* Write data */
+        rsp |= AT24Cxx_Program(dev, i, data, 0, (uint16_t)size);
+        data += size;
+
+        /* Self-timed Write cycle (finished by the next access when lazy) */
+        rsp |= AT24Cxx_WriteCycle(dev);
+
+        /* A device that stays busy does not come back within this write */
+        if (rsp & AT24Cxx_ETIMEOUT) return AT24Cxx_ETIMEOUT;
+    }
+
+    return rsp;
+}
+/**
+ * @brief  AT24Cxx erase memory data
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} saddr : start address
+ * @param  {uint8_t} fdata  : filling data (0x00 - 0xFF)
+ * @param  {uint32_t} size  : erase data size (See the "Byte" column in the 30 line list above)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ *                            2 --- timeout (AT24Cxx_TIMEOUT_MS)
+ * @note   none
+ */
+uint8_t AT24Cxx_Erase(at24cxx_t *dev, uint32_t saddr, uint8_t fdata, uint32_t size)
+{
+    uint32_t i = 0;
+    uint32_t RemainSize = size;
+    uint32_t EndAddr = saddr + size;
+    uint8_t rsp = 0;
+
+#if AT24Cxx_DEFER_PAGES != 0
+
+    /* Erase is part of an open transaction */
+    if (dev->defer != NULL && dev->defer->txn)
+    {
+        if (size > (uint32_t)AT24Cxx_DEFER_PAGES * dev->info.pagesize) return 1;
+        return AT24Cxx_Defer_Stage(dev, saddr, NULL, fdata, size);
+    }
+
+    AT24Cxx_Defer_Drop(dev, saddr, size);
+
+#endif
+
+    for (i = saddr; i < EndAddr; i += size)
+    {
+        /* Current erase size, Update remaining size */
+        size = AT24Cxx_ProgramSize(dev, i, RemainSize, 1);
+        RemainSize -= size;
+
+        /* Write filling data */
+        rsp |= AT24Cxx_Program(dev, i, NULL, fdata, (uint16_t)size);
+
+        /* Self-timed Write cycle (finished by the next access when lazy) */
+        rsp |= AT24Cxx_WriteCycle(dev);
+        if (rsp & AT24Cxx_ETIMEOUT) return AT24Cxx_ETIMEOUT;
+    }
+
+    return rsp;
+}
+#if AT24Cxx_CACHE_SETS != 0
+/*------------------------------------------------------*/
+/*                AT24Cxx Cache Function                */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx attach page cache
+ * @param  {at24cxx_t} *dev : device structure pointer (configured)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error (arena exhausted, device runs without cache)
+ * @note   Needs AT24Cxx_CACHE_SETS * AT24Cxx_CACHE_WAYS * (pagesize + 8) + 16 byte
+ *         of the arena. Only transfers of this driver keep the cache coherent,
+ *         invalidate it after the memory was changed otherwise.
+ */
+uint8_t AT24Cxx_Cache_Init(at24cxx_t *dev)
+{
+    AT24Cxx_CACHE_t *cache = (AT24Cxx_CACHE_t *)AT24Cxx_Arena_Alloc(sizeof(AT24Cxx_CACHE_t));
+    uint8_t *line = (uint8_t *)AT24Cxx_Arena_Alloc((uint32_t)AT24Cxx_CACHE_SETS * AT24Cxx_CACHE_WAYS * dev->info.pagesize);
+
+    dev->cache = NULL;
+    if (cache == NULL || line == NULL) return 1;
+
+    memset(cache, 0, sizeof(AT24Cxx_CACHE_t));
+    cache->line = line;
+    dev->cache = cache;
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx invalidate page cache
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return none
+ * @note   Statistics are kept
+ */
+void AT24Cxx_Cache_Invalidate(at24cxx_t *dev)
+{
+    if (dev->cache == NULL) return;
+
+    memset(dev->cache->tag, 0, sizeof(dev->cache->tag));
+}
+/**
+ * @brief  AT24Cxx page cache statistics
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint32_t} *hits   : pages served from the cache (may be NULL)
+ * @param  {uint32_t} *misses : pages read from the device, bypassing reads included (may be NULL)
+ * @return none
+ * @note   hit rate = hits / (hits + misses)
+ */
+void AT24Cxx_Cache_Stats(at24cxx_t *dev, uint32_t *hits, uint32_t *misses)
+{
+    if (hits != NULL) *hits = (dev->cache != NULL) ? dev->cache->hits : 0;
+    if (misses != NULL) *misses = (dev->cache != NULL) ? dev->cache->misses : 0;
+}
+#endif
+#if AT24Cxx_LAZY_WCYCLE != 0
+/*------------------------------------------------------*/
+/*           AT24Cxx Lazy Write Cycle Function          */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx attach lazy write cycle
+ * @param  {at24cxx_t} *dev : device structure pointer (configured)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error (arena exhausted, device keeps blocking waits)
+ * @note   Write and Erase return after the last page program without waiting, the
+ *         next access of this device polls it first. Reads of the bytes just
+ *         programmed are served from a page buffer taken from the arena.
+ */
+uint8_t AT24Cxx_Lazy_Init(at24cxx_t *dev)
+{
+    AT24Cxx_PEND_t *pend = (AT24Cxx_PEND_t *)AT24Cxx_Arena_Alloc(sizeof(AT24Cxx_PEND_t));
+    uint8_t *data = (uint8_t *)AT24Cxx_Arena_Alloc(dev->info.pagesize);
+
+    dev->pend = NULL;
+    if (pend == NULL || data == NULL) return 1;
+
+    pend->busy = 0;
+    pend->addr = 0;
+    pend->size = 0;
+    pend->data = data;
+    dev->pend = pend;
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx finish the pending write cycle
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint8_t}        : 0 --- success
+ *                            2 --- timeout
+ * @note   Call before power down or before another master uses the device
+ */
+uint8_t AT24Cxx_Lazy_Sync(at24cxx_t *dev)
+{
+    return AT24Cxx_Settle(dev);
+}
+#endif
+#if AT24Cxx_DEFER_PAGES != 0
+/*------------------------------------------------------*/
+/*             AT24Cxx Deferred Write Function          */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx attach staging buffer
+ * @param  {at24cxx_t} *dev : device structure pointer (configured)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error (arena exhausted, writes are not deferred)
+ * @note   Needs AT24Cxx_DEFER_PAGES * (pagesize + 40) + 16 byte of the arena
+ */
+uint8_t AT24Cxx_Defer_Init(at24cxx_t *dev)
+{
+    AT24Cxx_DEFER_t *defer = (AT24Cxx_DEFER_t *)AT24Cxx_Arena_Alloc(sizeof(AT24Cxx_DEFER_t));
+    uint8_t *data = (uint8_t *)AT24Cxx_Arena_Alloc((uint32_t)AT24Cxx_DEFER_PAGES * dev->info.pagesize);
+
+    dev->defer = NULL;
+    if (defer == NULL || data == NULL) return 1;
+
+    memset(defer, 0, sizeof(AT24Cxx_DEFER_t));
+    defer->data = data;
+    dev->defer = defer;
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx deferred write idle hook
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint16_t} budget  : maximum number of pages to program
+ * @return {uint8_t}          : 0 --- success
+ *                              1 --- error
+ * @note   Programs full pages and pages older than AT24Cxx_DEFER_LATENCY, partly
+ *         written pages stay staged for more writes until then. Nothing is
+ *         programmed while a transaction is open.
+ */
+uint8_t AT24Cxx_Defer_Idle(at24cxx_t *dev, uint16_t budget)
+{
+    AT24Cxx_DEFER_t *defer = dev->defer;
+    uint32_t now = AT24CXX_GETTICK();
+    uint32_t slot, i;
+    uint8_t full;
+
+    if (defer == NULL || defer->txn) return 0;
+
+    for (slot = 0; slot < AT24Cxx_DEFER_PAGES && budget > 0; slot++)
+    {
+        if (defer->tag[slot] == 0) continue;
+
+        for (full = 1, i = 0; i < dev->info.pagesize && full; i++)
+        {
+            full = AT24Cxx_Defer_Dirty(dev, slot, i);
+        }
+
+        if (full || now - defer->stamp[slot] >= AT24Cxx_DEFER_LATENCY)
+        {
+            if (AT24Cxx_Defer_Program(dev, slot)) return 1;
+            budget--;
+        }
+    }
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx program all staged pages
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ * @note   Call before power down
+ */
+uint8_t AT24Cxx_Defer_Flush(at24cxx_t *dev)
+{
+    uint32_t slot;
+    uint8_t rsp = 0;
+
+    if (dev->defer == NULL) return 0;
+
+    for (slot = 0; slot < AT24Cxx_DEFER_PAGES; slot++)
+    {
+        if (dev->defer->tag[slot] != 0) rsp |= AT24Cxx_Defer_Program(dev, slot);
+    }
+
+    return rsp;
+}
+/*------------------------------------------------------*/
+/*             AT24Cxx Transaction Function             */
+/*------------------------------------------------------*/
+/* Journal : header | entries (address 4, length 2, data) */
+#define AT24Cxx_TXN_MAGIC           0x4A54          /* "TJ" */
+#define AT24Cxx_TXN_HEADSIZE        8               /* magic 2, count 2, length 2, crc 2 */
+#define AT24Cxx_TXN_ENTRYSIZE       6
+
+/**
+ * @brief  AT24Cxx program data bypassing the staging buffer
+ * @param  {at24cxx_t} *dev      : device structure pointer
+ * @param  {uint32_t} saddr      : start address
+ * @param  {const uint8_t} *data : write data pointer
+ * @param  {uint32_t} size       : write data size
+ * @return {uint8_t}             : 0 --- success
+ *                                 1 --- error
+ */
+static uint8_t AT24Cxx_Txn_Put(at24cxx_t *dev, uint32_t saddr, const uint8_t *data, uint32_t size)
+{
+    uint16_t len;
+    uint8_t rsp = 0;
+
+    while (size > 0)
+    {
+        len = AT24Cxx_ProgramSize(dev, saddr, size, 0);
+        rsp |= AT24Cxx_Program(dev, saddr, data, 0, len);
+        rsp |= AT24Cxx_WriteCycle(dev);
+        if (rsp & AT24Cxx_ETIMEOUT) return AT24Cxx_ETIMEOUT;
+
+        saddr += len;
+        data += len;
+        size -= len;
+    }
+
+    return rsp;
+}
+/**
+ * @brief  AT24Cxx check staged pages against an address range
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} addr  : start address
+ * @param  {uint32_t} size  : range size
+ * @return {uint8_t}        : 0 --- no staged page in the range
+ *                            1 --- a staged page overlaps the range
+ */
+static uint8_t AT24Cxx_Txn_Overlap(at24cxx_t *dev, uint32_t addr, uint32_t size)
+{
+    uint32_t slot, base;
+
+    for (slot = 0; slot < AT24Cxx_DEFER_PAGES; slot++)
+    {
+        if (dev->defer->tag[slot] == 0) continue;
+        base = (dev->defer->tag[slot] - 1) * dev->info.pagesize;
+        if (base < addr + size && addr < base + dev->info.pagesize) return 1;
+    }
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx set transaction journal
+ * @param  {at24cxx_t} *dev : device structure pointer (staging buffer attached)
+ * @param  {uint32_t} addr  : journal address (page aligned)
+ * @param  {uint32_t} size  : journal size, 0 --- transactions are not atomic
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error (misaligned, or staged pages inside the area)
+ * @note   The journal needs 8 + (6 + pagesize) * AT24Cxx_DEFER_PAGES byte for
+ *         the largest transaction. Call AT24Cxx_Txn_Recover at startup.
+ */
+uint8_t AT24Cxx_Txn_Journal(at24cxx_t *dev, uint32_t addr, uint32_t size)
+{
+    if (dev->defer == NULL || dev->defer->txn || addr % dev->info.pagesize != 0) return 1;
+    if (AT24Cxx_Txn_Overlap(dev, addr, size)) return 1;
+
+    dev->defer->jaddr = addr;
+    dev->defer->jsize = size;
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx begin transaction
+ * @param  {at24cxx_t} *dev : device structure pointer (staging buffer attached)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ * @note   Staged writes of before are programmed first. Until commit, Write and
+ *         Erase only stage data and fail when the staging pages are exhausted,
+ *         the transaction is then partly staged and should be aborted.
+ */
+uint8_t AT24Cxx_Txn_Begin(at24cxx_t *dev)
+{
+    if (dev->defer == NULL || dev->defer->txn) return 1;
+    if (AT24Cxx_Defer_Flush(dev)) return 1;
+
+    dev->defer->txn = 1;
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx abort transaction (staged data is dropped)
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return none
+ * @note   After a commit failed behind a sealed journal, the journal stays
+ *         sealed and AT24Cxx_Txn_Recover completes the transaction.
+ */
+void AT24Cxx_Txn_Abort(at24cxx_t *dev)
+{
+    if (dev->defer == NULL) return;
+
+    memset(dev->defer->tag, 0, sizeof(dev->defer->tag));
+    memset(dev->defer->dirty, 0, sizeof(dev->defer->dirty));
+    dev->defer->txn = 0;
+    dev->defer->sealed = 0;
+}
+/**
+ * @brief  AT24Cxx replay sealed journal
+ * @param  {at24cxx_t} *dev : device structure pointer (journal set)
+ * @return {uint8_t}        : 0 --- journal replayed
+ *                            1 --- error
+ *                            2 --- no valid seal (nothing replayed)
+ * @note   The seal is cleared afterwards
+ */
+static uint8_t AT24Cxx_Txn_Replay(at24cxx_t *dev)
+{
+    AT24Cxx_DEFER_t *defer = dev->defer;
+    uint8_t head[AT24Cxx_TXN_HEADSIZE], buf[16];
+    uint32_t pos, end, addr, len, n, count;
+    uint16_t crc;
+    uint8_t rsp = 2;
+
+    if (AT24Cxx_Fetch(dev, defer->jaddr, head, AT24Cxx_TXN_HEADSIZE)) return 1;
+    if ((head[0] | (head[1] << 8)) != AT24Cxx_TXN_MAGIC) return 2;
+
+    count = head[2] | (head[3] << 8);
+    end = defer->jaddr + AT24Cxx_TXN_HEADSIZE + (head[4] | (head[5] << 8));
+
+    /* Check the seal */
+    crc = AT24Cxx_Crc16(0xFFFF, head + 2, 4);
+    for (pos = defer->jaddr + AT24Cxx_TXN_HEADSIZE; pos < end && end <= defer->jaddr + defer->jsize; pos += n)
+    {
+        n = min(sizeof(buf), end - pos);
+        if (AT24Cxx_Fetch(dev, pos, buf, n)) return 1;
+        crc = AT24Cxx_Crc16(crc, buf, n);
+    }
+
+    /* Replay */
+    if (end <= defer->jaddr + defer->jsize && crc == (head[6] | (head[7] << 8)))
+    {
+        for (pos = defer->jaddr + AT24Cxx_TXN_HEADSIZE; count > 0; count--)
+        {
+            if (AT24Cxx_Fetch(dev, pos, buf, AT24Cxx_TXN_ENTRYSIZE)) return 1;
+            addr = buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+            len = buf[4] | (buf[5] << 8);
+            pos += AT24Cxx_TXN_ENTRYSIZE;
+
+            for (; len > 0; len -= n)
+            {
+                n = min(sizeof(buf), len);
+                if (AT24Cxx_Fetch(dev, pos, buf, n)) return 1;
+                if (AT24Cxx_Txn_Put(dev, addr, buf, n)) return 1;
+                pos += n;
+                addr += n;
+            }
+        }
+        rsp = 0;
+    }
+
+    head[0] = head[1] = 0xFF;
+    if (AT24Cxx_Txn_Put(dev, defer->jaddr, head, 2)) return 1;
+
+    return rsp;
+}
+/**
+ * @brief  AT24Cxx commit transaction
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error (transaction stays open, retry or abort)
+ * @note   Every touched page is programmed once. With a journal, the pages are
+ *         first written to the journal and sealed by its header, so a power
+ *         loss leaves either the old or, after AT24Cxx_Txn_Recover, the new data.
+ *         A retry after a failure behind the seal replays the sealed journal.
+ */
+uint8_t AT24Cxx_Txn_Commit(at24cxx_t *dev)
+{
+    AT24Cxx_DEFER_t *defer = dev->defer;
+    uint8_t head[AT24Cxx_TXN_HEADSIZE], entry[AT24Cxx_TXN_ENTRYSIZE];
+    uint32_t slot, lo, hi, base, pos, count = 0, length = 0;
+    uint16_t crc;
+    uint8_t rsp;
+
+    if (defer == NULL || !defer->txn) return 1;
+
+    /* Retry behind the seal : the journal holds the whole transaction */
+    if (defer->sealed)
+    {
+        rsp = AT24Cxx_Txn_Replay(dev);
+        if (rsp == 1) return 1;
+        defer->sealed = 0;
+        if (rsp == 0)
+        {
+            AT24Cxx_Txn_Abort(dev);
+            return 0;
+        }
+    }
+
+    for (slot = 0; slot < AT24Cxx_DEFER_PAGES; slot++)
+    {
+        if (defer->tag[slot] == 0) continue;
+        if (AT24Cxx_Defer_Span(dev, slot, &lo, &hi)) return 1;
+        count++;
+        length += AT24Cxx_TXN_ENTRYSIZE + hi - lo;
+    }
+
+    if (defer->jsize != 0 && count != 0)
+    {
+        if (length > 0xFFFF || AT24Cxx_TXN_HEADSIZE + length > defer->jsize) return 1;
+        if (AT24Cxx_Txn_Overlap(dev, defer->jaddr, defer->jsize)) return 1;
+
+        /* A stale seal must not cover the new entries */
+        head[0] = head[1] = 0xFF;
+        if (AT24Cxx_Txn_Put(dev, defer->jaddr, head, 2)) return 1;
+
+        head[2] = (uint8_t)count;
+        head[3] = (uint8_t)(count >> 8);
+        head[4] = (uint8_t)length;
+        head[5] = (uint8_t)(length >> 8);
+        crc = AT24Cxx_Crc16(0xFFFF, head + 2, 4);
+
+        /* Journal entries */
+        pos = defer->jaddr + AT24Cxx_TXN_HEADSIZE;
+        for (slot = 0; slot < AT24Cxx_DEFER_PAGES; slot++)
+        {
+            if (defer->tag[slot] == 0) continue;
+            AT24Cxx_Defer_Span(dev, slot, &lo, &hi);
+            base = (defer->tag[slot] - 1) * dev->info.pagesize + lo;
+
+            entry[0] = (uint8_t)base;
+            entry[1] = (uint8_t)(base >> 8);
+            entry[2] = (uint8_t)(base >> 16);
+            entry[3] = (uint8_t)(base >> 24);
+            entry[4] = (uint8_t)(hi - lo);
+            entry[5] = (uint8_t)((hi - lo) >> 8);
+            crc = AT24Cxx_Crc16(crc, entry, AT24Cxx_TXN_ENTRYSIZE);
+            crc = AT24Cxx_Crc16(crc, defer->data + slot * dev->info.pagesize + lo, hi - lo);
+
+            if (AT24Cxx_Txn_Put(dev, pos, entry, AT24Cxx_TXN_ENTRYSIZE)) return 1;
+            if (AT24Cxx_Txn_Put(dev, pos + AT24Cxx_TXN_ENTRYSIZE, defer->data + slot * dev->info.pagesize + lo, hi - lo)) return 1;
+            pos += AT24Cxx_TXN_ENTRYSIZE + hi - lo;
+        }
+
+        /* Seal */
+        head[0] = (uint8_t)AT24Cxx_TXN_MAGIC;
+        head[1] = (uint8_t)(AT24Cxx_TXN_MAGIC >> 8);
+        head[6] = (uint8_t)crc;
+        head[7] = (uint8_t)(crc >> 8);
+        if (AT24Cxx_Txn_Put(dev, defer->jaddr, head, AT24Cxx_TXN_HEADSIZE)) return 1;
+        defer->sealed = 1;
+    }
+
+    /* Pages stay staged until the end, a retry programs all of them again */
+    for (slot = 0; slot < AT24Cxx_DEFER_PAGES; slot++)
+    {
+        if (defer->tag[slot] == 0) continue;
+        AT24Cxx_Defer_Span(dev, slot, &lo, &hi);
+        base = (defer->tag[slot] - 1) * dev->info.pagesize + lo;
+        if (AT24Cxx_Txn_Put(dev, base, defer->data + slot * dev->info.pagesize + lo, hi - lo)) return 1;
+    }
+
+    /* Unseal */
+    if (defer->sealed)
+    {
+        head[0] = head[1] = 0xFF;
+        if (AT24Cxx_Txn_Put(dev, defer->jaddr, head, 2)) return 1;
+    }
+
+    AT24Cxx_Txn_Abort(dev);
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx recover interrupted transaction
+ * @param  {at24cxx_t} *dev : device structure pointer (journal set)
+ * @return {uint8_t}        : 0 --- success (nothing to do, or sealed journal replayed)
+ *                            1 --- error
+ * @note   Call at startup before reading the data. A journal without a valid seal
+ *         is ignored, the transaction never took effect.
+ */
+uint8_t AT24Cxx_Txn_Recover(at24cxx_t *dev)
+{
+    if (dev->defer == NULL || dev->defer->jsize == 0) return 1;
+
+    return (AT24Cxx_Txn_Replay(dev) == 1) ? 1 : 0;
+}
+#endif
+/*------------------------------------------------------*/
+/*             AT24Cxx Application Function             */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx Write data and read back for verification
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} addr  : start address
+ * @param  {uint8_t} *data  : write data pointer
+ * @param  {uint32_t} size  : write data size (See the "Byte" column in the 30 line list above)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ * @note   Bus errors of the write or of any read back are errors,
+ *         the read back bypasses the page cache
+ */
+uint8_t AT24Cxx_Readback_Write(at24cxx_t *dev, uint32_t addr, uint8_t *data, uint32_t size)
+{
+    uint8_t compare_data[AT24Cxx_MAX_COMPARE_SIZE];
+    uint32_t point, len, j;
+
+    /* write Data */
+    if (AT24Cxx_Write(dev, addr, data, size)) return 1;
+
+#if AT24Cxx_DEFER_PAGES != 0
+
+    /* Read back needs the data in the memory */
+    if (AT24Cxx_Defer_Flush(dev)) return 1;
+
+#endif
+
+    /* compare copies of at most AT24Cxx_MAX_COMPARE_SIZE */
+    for (point = 0; point < size; point += len)
+    {
+        len = min(size - point, AT24Cxx_MAX_COMPARE_SIZE);
+        if (AT24Cxx_Fetch(dev, addr + point, compare_data, len)) return 1;
+        for (j = 0; j < len; j++)
+        {
+            if (data[point + j] != compare_data[j]) return 1;
+        }
+    }
+
+    return 0;
+}
+/*------------------------------------------------------*/
+/*               AT24Cxx Layout Function                */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx get update frequency class of a record
+ * @param  {uint32_t} freq : update frequency
+ * @return {uint8_t}       : frequency class (0 : never updated, n : 2^(n-1) <= freq < 2^n)
+ * @note   Records of different class never share a page
+ */
+static uint8_t AT24Cxx_Layout_Class(uint32_t freq)
+{
+    uint8_t cls = 0;
+
+    while (freq)
+    {
+        freq >>= 1;
+        cls++;
+    }
+
+    return cls;
+}
+/**
+ * @brief  AT24Cxx get write cycles of one record save
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @param  {uint32_t} addr  : record start address
+ * @param  {uint32_t} size  : record size
+ * @return {uint16_t}       : number of page programs
+ * @note   none
+ */
+static uint16_t AT24Cxx_Layout_Cycles(at24cxx_t *dev, uint32_t addr, uint32_t size)
+{
+    if (size == 0) return 0;
+
+    return (uint16_t)((addr + size - 1) / dev->info.pagesize - addr / dev->info.pagesize + 1);
+}
+/**
+ * @brief  AT24Cxx plan record addresses for minimal page crossings
+ * @param  {at24cxx_t} *dev         : device structure pointer
+ * @param  {AT24Cxx_RECORD_t} *rec  : record list (size and freq in, addr and cycles out)
+ * @param  {uint16_t} num           : number of records
+ * @param  {uint32_t} saddr         : start address of the layout area (rounded up to page)
+ * @param  {uint32_t} *eaddr        : end address of the layout area (page aligned, may be NULL)
+ * @return {uint8_t}                : 0 --- success
+ *                                    1 --- error (layout exceeds chip capacity)
+ * @note   Records are placed hottest first. Records of the same frequency class are
+ *         packed first-fit into the pages of that class, a record that fits in one
+ *         page never straddles a page boundary, and each class starts on a new page
+ *         so hot and cold records never share a page.
+ */
+uint8_t AT24Cxx_Layout_Plan(at24cxx_t *dev, AT24Cxx_RECORD_t *rec, uint16_t num, uint32_t saddr, uint32_t *eaddr)
+{
+    uint16_t i, j, sel;
+    uint16_t pagesize = dev->info.pagesize;
+    uint32_t page, pend, used;
+    uint32_t EndAddr, ClassAddr;
+    uint8_t cls, CurClass = 0xFF;
+
+    /* Align start address to page */
+    EndAddr = (saddr + pagesize - 1) / pagesize * pagesize;
+    ClassAddr = EndAddr;
+
+    for (i = 0; i < num; i++)
+    {
+        rec[i].addr = AT24Cxx_LAYOUT_NONE;
+        rec[i].cycles = 0;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        /* Select the hottest record, the largest one first within a class */
+        sel = num;
+        for (j = 0; j < num; j++)
+        {
+            if (rec[j].addr != AT24Cxx_LAYOUT_NONE) continue;
+            if (sel == num || \
+                AT24Cxx_Layout_Class(rec[j].freq) > AT24Cxx_Layout_Class(rec[sel].freq) || \
+               (AT24Cxx_Layout_Class(rec[j].freq) == AT24Cxx_Layout_Class(rec[sel].freq) && rec[j].size > rec[sel].size))
+            {
+                sel = j;
+            }
+        }
+
+        /* Separate frequency classes by page */
+        cls = AT24Cxx_Layout_Class(rec[sel].freq);
+        if (cls != CurClass)
+        {
+            CurClass = cls;
+            ClassAddr = EndAddr;
+        }
+
+        /* First fit in the pages of the current class */
+        rec[sel].addr = EndAddr;
+        if (rec[sel].size <= pagesize)
+        {
+            for (page = ClassAddr; page < EndAddr; page += pagesize)
+            {
+                /* Get the used end of this page */
+                pend = page + pagesize;
+                used = page;
+                for (j = 0; j < num; j++)
+                {
+                    if (j == sel || rec[j].addr == AT24Cxx_LAYOUT_NONE) continue;
+                    if (rec[j].addr + rec[j].size > page && rec[j].addr < pend)
+                    {
+                        used = max(used, rec[j].addr + rec[j].size);
+                    }
+                }
+
+                if (used < pend && pend - used >= rec[sel].size)
+                {
+                    rec[sel].addr = used;
+                    break;
+                }
+            }
+        }
+
+        /* Open new page(s) */
+        if (rec[sel].addr == EndAddr)
+        {
+            EndAddr += (rec[sel].size + pagesize - 1) / pagesize * pagesize;
+        }
+
+        rec[sel].cycles = AT24Cxx_Layout_Cycles(dev, rec[sel].addr, rec[sel].size);
+    }
+
+    if (eaddr != NULL) *eaddr = EndAddr;
+
+    return (EndAddr > AT24Cxx_CAPACITY(dev->info.type)) ? 1 : 0;
+}
+/**
+ * @brief  AT24Cxx evaluate expected write cycles of a record layout
+ * @param  {at24cxx_t} *dev         : device structure pointer
+ * @param  {AT24Cxx_RECORD_t} *rec  : record list (size, freq and addr in, cycles out)
+ * @param  {uint16_t} num           : number of records
+ * @return {uint32_t}               : sum of freq * cycles, page programs per unit time
+ * @note   Use to compare hand-made layouts against AT24Cxx_Layout_Plan.
+ *         Records at AT24Cxx_LAYOUT_NONE are skipped (cycles 0).
+ */
+uint32_t AT24Cxx_Layout_Cost(at24cxx_t *dev, AT24Cxx_RECORD_t *rec, uint16_t num)
+{
+    uint16_t i;
+    uint32_t cost = 0;
+
+    for (i = 0; i < num; i++)
+    {
+        /* Records left unplaced cost nothing */
+        if (rec[i].addr == AT24Cxx_LAYOUT_NONE)
+        {
+            rec[i].cycles = 0;
+            continue;
+        }
+
+        rec[i].cycles = AT24Cxx_Layout_Cycles(dev, rec[i].addr, rec[i].size);
+        cost += rec[i].freq * rec[i].cycles;
+    }
+
+    return cost;
+}
+/*------------------------------------------------------*/
+/*          AT24Cxx Persistent Variable Function        */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx get one page segment of a persistent variable
+ * @param  {at24cxx_t} *dev      : device structure pointer
+ * @param  {AT24Cxx_VAR_t} *var  : persistent variable pointer
+ * @param  {uint16_t} seg        : segment index (n-th page touched by the variable)
+ * @param  {uint16_t} *len       : segment length (0 : beyond the variable)
+ * @return {uint16_t}            : segment offset in the variable
+ * @note   none
+ */
+static uint16_t AT24Cxx_Var_Segment(at24cxx_t *dev, AT24Cxx_VAR_t *var, uint16_t seg, uint16_t *len)
+{
+    uint32_t off = 0;
+    uint16_t first = dev->info.pagesize - (var->addr % dev->info.pagesize);
+
+    if (seg > 0)
+    {
+        off = first + (uint32_t)(seg - 1) * dev->info.pagesize;
+    }
+
+    if (off >= var->size)
+    {
+        *len = 0;
+        return var->size;
+    }
+
+    *len = (uint16_t)min((uint32_t)var->size - off, (uint32_t)(seg == 0 ? first : dev->info.pagesize));
+
+    return (uint16_t)off;
+}
+/**
+ * @brief  AT24Cxx get persistent variable (load on first access)
+ * @param  {at24cxx_t} *dev      : device structure pointer
+ * @param  {AT24Cxx_VAR_t} *var  : persistent variable pointer
+ * @return {const void *}        : RAM image, NULL --- read error
+ * @note   Only the first access reads the EEPROM
+ */
+const void *AT24Cxx_Var_Get(at24cxx_t *dev, AT24Cxx_VAR_t *var)
+{
+    if (!(var->state & AT24Cxx_VAR_LOADED))
+    {
+        if (AT24Cxx_Read(dev, var->addr, (uint8_t *)var->ram, var->size)) return NULL;
+
+        var->state |= AT24Cxx_VAR_LOADED;
+        var->dirty = 0;
+    }
+
+    return var->ram;
+}
+/**
+ * @brief  AT24Cxx set persistent variable
+ * @param  {at24cxx_t} *dev      : device structure pointer
+ * @param  {AT24Cxx_VAR_t} *var  : persistent variable pointer
+ * @param  {const void} *val     : new value (var->size byte)
+ * @return {uint8_t}             : 0 --- success
+ *                                 1 --- error
+ * @note   Only the RAM image is updated. Pages whose content is unchanged are
+ *         not marked dirty and will not be programmed by AT24Cxx_Var_Commit.
+ */
+uint8_t AT24Cxx_Var_Set(at24cxx_t *dev, AT24Cxx_VAR_t *var, const void *val)
+{
+    uint16_t seg, off, len;
+    uint8_t *ram = (uint8_t *)var->ram;
+    const uint8_t *src = (const uint8_t *)val;
+
+    if (AT24Cxx_Var_Get(dev, var) == NULL) return 1;
+
+    for (seg = 0; ; seg++)
+    {
+        off = AT24Cxx_Var_Segment(dev, var, seg, &len);
+        if (len == 0) break;
+
+        /* Compare page segment */
+        if (memcmp(ram + off, src + off, len) != 0)
+        {
+            memcpy(ram + off, src + off, len);
+            var->dirty |= 1UL << min(seg, 31);
+        }
+    }
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx invalidate a boot region
+ * @param  {at24cxx_t} *dev       : device structure pointer
+ * @param  {AT24Cxx_BOOT_t} *boot : boot region pointer
+ * @return {uint8_t}              : 0 --- success
+ *                                  1 --- error
+ * @note   Clears the magic before a variable of the region is programmed, so
+ *         the packed copy is never valid over stale data. Nothing is written
+ *         when the region is not loaded or already invalid.
+ */
+static uint8_t AT24Cxx_Boot_Invalidate(at24cxx_t *dev, AT24Cxx_BOOT_t *boot)
+{
+    if (boot->image == NULL || (boot->image[0] == 0xFF && boot->image[1] == 0xFF)) return 0;
+
+    boot->image[0] = boot->image[1] = 0xFF;
+
+    return AT24Cxx_Write(dev, boot->addr, boot->image, 2);
+}
+/**
+ * @brief  AT24Cxx program the dirty pages of a persistent variable
+ * @param  {at24cxx_t} *dev      : device structure pointer
+ * @param  {AT24Cxx_VAR_t} *var  : persistent variable pointer
+ * @return {uint8_t}             : 0 --- success
+ *                                 1 --- error
+ * @note   none
+ */
+static uint8_t AT24Cxx_Var_Flush(at24cxx_t *dev, AT24Cxx_VAR_t *var)
+{
+    uint16_t seg, off, len;
+    uint8_t *ram = (uint8_t *)var->ram;
+
+    for (seg = 0; var->dirty != 0; seg++)
+    {
+        off = AT24Cxx_Var_Segment(dev, var, seg, &len);
+        if (len == 0) break;
+
+        if (var->dirty & (1UL << min(seg, 31)))
+        {
+            if (AT24Cxx_Write(dev, var->addr + off, ram + off, len)) return 1;
+
+            /* Page 31 and above share the last dirty bit */
+            if (seg < 31) var->dirty &= ~(1UL << seg);
+        }
+    }
+
+    var->dirty = 0;
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx commit persistent variable
+ * @param  {at24cxx_t} *dev      : device structure pointer
+ * @param  {AT24Cxx_VAR_t} *var  : persistent variable pointer
+ * @return {uint8_t}             : 0 --- success
+ *                                 1 --- error
+ * @note   Programs the changed pages only, nothing when the variable is clean.
+ *         A variable of a boot region invalidates the region first, the next
+ *         AT24Cxx_Boot_Commit or AT24Cxx_Boot_Load rebuilds it.
+ */
+uint8_t AT24Cxx_Var_Commit(at24cxx_t *dev, AT24Cxx_VAR_t *var)
+{
+    if (var->dirty != 0 && var->boot != NULL)
+    {
+        if (AT24Cxx_Boot_Invalidate(dev, var->boot)) return 1;
+    }
+
+    return AT24Cxx_Var_Flush(dev, var);
+}
+/*------------------------------------------------------*/
+/*            AT24Cxx Versioned Record Function         */
+/*------------------------------------------------------*/
+/* Schema_Load result : no valid record stored */
+#define AT24Cxx_SCHEMA_NONE         3
+
+/**
+ * @brief  AT24Cxx load versioned record (migrate an older layout in RAM)
+ * @param  {at24cxx_t} *dev         : device structure pointer
+ * @param  {AT24Cxx_SCHEMA_t} *rec  : versioned record pointer
+ * @return {uint8_t}                : 0 --- success (or already loaded)
+ *                                    1 --- error (bus error, newer layout, missing or failed migration)
+ *                                    AT24Cxx_ETIMEOUT --- write cycle timeout
+ *                                    AT24Cxx_SCHEMA_NONE --- no record or invalid header
+ * @note   none
+ */
+static uint8_t AT24Cxx_Schema_Load(at24cxx_t *dev, AT24Cxx_SCHEMA_t *rec)
+{
+    uint8_t head[AT24Cxx_SCHEMA_HEADSIZE];
+    uint16_t size;
+    uint8_t v, rsp;
+
+    if (rec->var.state & AT24Cxx_VAR_LOADED) return 0;
+
+    rsp = AT24Cxx_Read(dev, rec->var.addr - AT24Cxx_SCHEMA_HEADSIZE, head, AT24Cxx_SCHEMA_HEADSIZE);
+    if (rsp != 0) return rsp;
+
+    v = head[0];
+    size = (uint16_t)(head[2] | (head[3] << 8));
+    if ((head[0] ^ head[1]) != 0xFF || size == 0 || size > rec->var.size) return AT24Cxx_SCHEMA_NONE;
+    if (v == rec->version && size != rec->var.size) return AT24Cxx_SCHEMA_NONE;
+
+    /* Written by a newer layout, keep it */
+    if (v > rec->version) return 1;
+
+    rsp = AT24Cxx_Read(dev, rec->var.addr, (uint8_t *)rec->var.ram, size);
+    if (rsp != 0) return rsp;
+
+    /* Older layout */
+    for (; v < rec->version; v++)
+    {
+        if (rec->migrate == NULL || rec->migrate[v] == NULL) return 1;
+
+        size = rec->migrate[v](rec->var.ram, size);
+        if (size == 0 || size > rec->var.size) return 1;
+    }
+    if (size != rec->var.size) return 1;
+
+    rec->var.state |= AT24Cxx_VAR_LOADED;
+    rec->var.dirty = 0;
+    rec->stale = (head[0] != rec->version);
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx get versioned record (load and migrate on first access)
+ * @param  {at24cxx_t} *dev         : device structure pointer
+ * @param  {AT24Cxx_SCHEMA_t} *rec  : versioned record pointer
+ * @return {const void *}           : RAM image in the current layout,
+ *                                    NULL --- read error, no valid record, newer layout or failed migration
+ * @note   An older layout is migrated in RAM only, the EEPROM keeps it until the
+ *         record is next modified and committed.
+ */
+const void *AT24Cxx_Schema_Get(at24cxx_t *dev, AT24Cxx_SCHEMA_t *rec)
+{
+    if (AT24Cxx_Schema_Load(dev, rec)) return NULL;
+
+    return rec->var.ram;
+}
+/**
+ * @brief  AT24Cxx set versioned record
+ * @param  {at24cxx_t} *dev         : device structure pointer
+ * @param  {AT24Cxx_SCHEMA_t} *rec  : versioned record pointer
+ * @param  {const void} *val        : new value (current layout)
+ * @return {uint8_t}                : 0 --- success
+ *                                    1 --- error (bus error, newer layout, missing or failed migration)
+ *                                    AT24Cxx_ETIMEOUT --- write cycle timeout
+ * @note   Only the RAM image is updated. A record stored in an older layout, or
+ *         not stored at all (no valid header), is rewritten whole by the next
+ *         commit. Any other load error leaves the EEPROM record untouched.
+ */
+uint8_t AT24Cxx_Schema_Set(at24cxx_t *dev, AT24Cxx_SCHEMA_t *rec, const void *val)
+{
+    uint8_t rsp = AT24Cxx_Schema_Load(dev, rec);
+
+    if (rsp == AT24Cxx_SCHEMA_NONE)
+    {
+        rec->var.state |= AT24Cxx_VAR_LOADED;
+        rec->stale = 1;
+    }
+    else if (rsp != 0)
+    {
+        return rsp;
+    }
+
+    if (!rec->stale) return AT24Cxx_Var_Set(dev, &rec->var, val);
+
+    memcpy(rec->var.ram, val, rec->var.size);
+    rec->var.dirty = 0xFFFFFFFFUL;
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx commit versioned record
+ * @param  {at24cxx_t} *dev         : device structure pointer
+ * @param  {AT24Cxx_SCHEMA_t} *rec  : versioned record pointer
+ * @return {uint8_t}                : 0 --- success
+ *                                    1 --- error
+ * @note   Changed pages only, nothing when unmodified (even if migrated). A
+ *         layout rewrite invalidates the header first, so a power loss leaves
+ *         no valid record rather than a mixed one.
+ */
+uint8_t AT24Cxx_Schema_Commit(at24cxx_t *dev, AT24Cxx_SCHEMA_t *rec)
+{
+    uint32_t addr = rec->var.addr - AT24Cxx_SCHEMA_HEADSIZE;
+    uint8_t head[AT24Cxx_SCHEMA_HEADSIZE];
+
+    if (!rec->stale || rec->var.dirty == 0) return AT24Cxx_Var_Commit(dev, &rec->var);
+
+    head[0] = head[1] = 0xFF;
+    if (AT24Cxx_Write(dev, addr, head, 2)) return 1;
+    if (AT24Cxx_Var_Commit(dev, &rec->var)) return 1;
+
+    head[0] = rec->version;
+    head[1] = (uint8_t)~rec->version;
+    head[2] = (uint8_t)rec->var.size;
+    head[3] = (uint8_t)(rec->var.size >> 8);
+    if (AT24Cxx_Write(dev, addr, head, AT24Cxx_SCHEMA_HEADSIZE)) return 1;
+
+    rec->stale = 0;
+
+    return 0;
+}
+/*------------------------------------------------------*/
+/*              AT24Cxx Boot Region Function            */
+/*------------------------------------------------------*/
+/* Region : header | variables packed in list order */
+#define AT24Cxx_BOOT_MAGIC          0x5442          /* "BT" */
+#define AT24Cxx_BOOT_HEADSIZE       8               /* magic 2, count 2, length 2, crc 2 */
+
+/**
+ * @brief  AT24Cxx boot region packed length
+ * @param  {AT24Cxx_BOOT_t} *boot : boot region pointer
+ * @return {uint32_t}             : sum of the variable sizes
+ */
+static uint32_t AT24Cxx_Boot_Length(AT24Cxx_BOOT_t *boot)
+{
+    uint32_t len = 0;
+    uint16_t i;
+
+    for (i = 0; i < boot->num; i++)
+    {
+        len += boot->var[i]->size;
+    }
+
+    return len;
+}
+/**
+ * @brief  AT24Cxx boot region header
+ * @param  {AT24Cxx_BOOT_t} *boot : boot region pointer (image body up to date)
+ * @param  {uint32_t} len         : packed length
+ * @return none
+ * @note   Written into the head of the image
+ */
+static void AT24Cxx_Boot_Seal(AT24Cxx_BOOT_t *boot, uint32_t len)
+{
+    uint8_t *head = boot->image;
+    uint16_t crc;
+
+    head[2] = (uint8_t)boot->num;
+    head[3] = (uint8_t)(boot->num >> 8);
+    head[4] = (uint8_t)len;
+    head[5] = (uint8_t)(len >> 8);
+    crc = AT24Cxx_Crc16(0xFFFF, head + 2, 4);
+    crc = AT24Cxx_Crc16(crc, head + AT24Cxx_BOOT_HEADSIZE, len);
+
+    head[0] = (uint8_t)AT24Cxx_BOOT_MAGIC;
+    head[1] = (uint8_t)(AT24Cxx_BOOT_MAGIC >> 8);
+    head[6] = (uint8_t)crc;
+    head[7] = (uint8_t)(crc >> 8);
+}
+/**
+ * @brief  AT24Cxx load boot-critical variables
+ * @param  {at24cxx_t} *dev       : device structure pointer
+ * @param  {AT24Cxx_BOOT_t} *boot : boot region pointer
+ * @return {uint8_t}              : 0 --- success
+ *                                  1 --- error
+ * @note   One sequential read of the region fills every variable. When the
+ *         region is invalid (first boot, changed variable list, interrupted
+ *         commit) the variables are read from their own addresses and the
+ *         region is rebuilt. The image takes 8 + sum of sizes byte of the arena.
+ */
+uint8_t AT24Cxx_Boot_Load(at24cxx_t *dev, AT24Cxx_BOOT_t *boot)
+{
+    uint32_t len = AT24Cxx_Boot_Length(boot), off;
+    uint8_t *head, *body;
+    uint16_t i;
+    uint8_t valid;
+
+    if (len > 0xFFFF || boot->addr % dev->info.pagesize != 0) return 1;
+
+    if (boot->image == NULL)
+    {
+        boot->image = (uint8_t *)AT24Cxx_Arena_Alloc(AT24Cxx_BOOT_HEADSIZE + len);
+        if (boot->image == NULL) return 1;
+    }
+    head = boot->image;
+    body = boot->image + AT24Cxx_BOOT_HEADSIZE;
+
+    if (AT24Cxx_Read(dev, boot->addr, head, AT24Cxx_BOOT_HEADSIZE + len)) return 1;
+
+    valid = (head[0] | (head[1] << 8)) == AT24Cxx_BOOT_MAGIC &&
+            (head[2] | (head[3] << 8)) == boot->num &&
+            (uint32_t)(head[4] | (head[5] << 8)) == len &&
+            AT24Cxx_Crc16(AT24Cxx_Crc16(0xFFFF, head + 2, 4), body, len) == (head[6] | (head[7] << 8));
+
+    for (i = 0, off = 0; i < boot->num; off += boot->var[i++]->size)
+    {
+        boot->var[i]->boot = boot;
+
+        if (valid)
+        {
+            memcpy(boot->var[i]->ram, body + off, boot->var[i]->size);
+            boot->var[i]->state |= AT24Cxx_VAR_LOADED;
+            boot->var[i]->dirty = 0;
+            continue;
+        }
+
+        /* Canonical copy */
+        boot->var[i]->state &= (uint8_t)~AT24Cxx_VAR_LOADED;
+        if (AT24Cxx_Var_Get(dev, boot->var[i]) == NULL) return 1;
+        memcpy(body + off, boot->var[i]->ram, boot->var[i]->size);
+    }
+
+    if (valid) return 0;
+
+    /* Rebuild the region */
+    AT24Cxx_Boot_Seal(boot, len);
+
+    return AT24Cxx_Write(dev, boot->addr, head, AT24Cxx_BOOT_HEADSIZE + len);
+}
+/**
+ * @brief  AT24Cxx commit boot-critical variables
+ * @param  {at24cxx_t} *dev       : device structure pointer
+ * @param  {AT24Cxx_BOOT_t} *boot : boot region pointer (loaded)
+ * @return {uint8_t}              : 0 --- success
+ *                                  1 --- error
+ * @note   The region is invalidated, the variables are committed to their own
+ *         addresses, then the changed pages of the region and its header are
+ *         programmed. A power loss in between leaves the region invalid, the
+ *         next AT24Cxx_Boot_Load falls back to the variables. A region left
+ *         invalid by AT24Cxx_Var_Commit of a member is rebuilt here as well.
+ */
+uint8_t AT24Cxx_Boot_Commit(at24cxx_t *dev, AT24Cxx_BOOT_t *boot)
+{
+    uint32_t len = AT24Cxx_Boot_Length(boot), off, base, end, pos, lo, hi;
+    uint8_t changed;
+    uint16_t i;
+
+    if (boot->image == NULL) return 1;
+
+    /* Nothing to do while the region is valid and every variable is clean */
+    for (i = 0; i < boot->num && boot->var[i]->dirty == 0; i++);
+    if (i == boot->num && (boot->image[0] | (boot->image[1] << 8)) == AT24Cxx_BOOT_MAGIC) return 0;
+
+    if (AT24Cxx_Boot_Invalidate(dev, boot)) return 1;
+
+    for (i = 0; i < boot->num; i++)
+    {
+        if (AT24Cxx_Var_Flush(dev, boot->var[i])) return 1;
+    }
+
+    /* Changed pages of the packed variables */
+    for (base = 0; base < AT24Cxx_BOOT_HEADSIZE + len; base += dev->info.pagesize)
+    {
+        end = min(base + dev->info.pagesize, AT24Cxx_BOOT_HEADSIZE + len);
+        changed = 0;
+
+        for (i = 0, off = AT24Cxx_BOOT_HEADSIZE; i < boot->num && off < end; off += boot->var[i++]->size)
+        {
+            lo = max(off, base);
+            hi = min(off + boot->var[i]->size, end);
+            if (lo >= hi) continue;
+
+            pos = lo - off;
+            if (memcmp(boot->image + lo, (uint8_t *)boot->var[i]->ram + pos, hi - lo) != 0)
+            {
+                memcpy(boot->image + lo, (uint8_t *)boot->var[i]->ram + pos, hi - lo);
+                changed = 1;
+            }
+        }
+
+        if (changed)
+        {
+            lo = max(base, AT24Cxx_BOOT_HEADSIZE);
+            if (AT24Cxx_Write(dev, boot->addr + lo, boot->image + lo, end - lo)) return 1;
+        }
+    }
+
+    /* Validate */
+    AT24Cxx_Boot_Seal(boot, len);
+
+    return AT24Cxx_Write(dev, boot->addr, boot->image, AT24Cxx_BOOT_HEADSIZE);
+}
+/*------------------------------------------------------*/
+/*                AT24Cxx Shadow Function               */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx shadow init (allocate RAM copies and load the published one)
+ * @param  {AT24Cxx_SHADOW_t} *sh : shadow pointer
+ * @param  {at24cxx_t} *dev       : device structure pointer
+ * @param  {uint32_t} addr        : EEPROM address
+ * @param  {uint32_t} size        : range size
+ * @return {uint8_t}              : 0 --- success
+ *                                  1 --- error (arena exhausted or read error)
+ * @note   Call before readers are enabled
+ */
+uint8_t AT24Cxx_Shadow_Init(AT24Cxx_SHADOW_t *sh, at24cxx_t *dev, uint32_t addr, uint32_t size)
+{
+    sh->seq = 0;
+    sh->dev = dev;
+    sh->addr = addr;
+    sh->size = size;
+    sh->ram = (volatile uint8_t *)AT24Cxx_Arena_Alloc(2 * size);
+    if (sh->ram == NULL) return 1;
+
+    return AT24Cxx_Read(dev, addr, (uint8_t *)sh->ram, size);
+}
+/**
+ * @brief  AT24Cxx shadow read
+ * @param  {AT24Cxx_SHADOW_t} *sh : shadow pointer
+ * @param  {uint32_t} offset      : offset in the range
+ * @param  {void} *data           : read data pointer
+ * @param  {uint32_t} size        : read data size
+ * @return {uint8_t}              : 0 --- success
+ *                                  1 --- error (out of range, or copy republished for AT24Cxx_SHADOW_RETRY attempts)
+ * @note   Never blocks and never touches the bus, callable from interrupts.
+ *         The published copy is not modified until the writer publishes the
+ *         other one, so a reader the writer cannot preempt succeeds at once.
+ */
+uint8_t AT24Cxx_Shadow_Read(AT24Cxx_SHADOW_t *sh, uint32_t offset, void *data, uint32_t size)
+{
+    const volatile uint8_t *src;
+    uint8_t *dst;
+    uint32_t seq, n, i;
+
+    if (offset > sh->size || size > sh->size - offset) return 1;
+
+    for (n = 0; n < AT24Cxx_SHADOW_RETRY; n++)
+    {
+        seq = sh->seq;
+        AT24Cxx_BARRIER();
+
+        src = sh->ram + (seq & 1) * sh->size + offset;
+        dst = (uint8_t *)data;
+        for (i = 0; i < size; i++) dst[i] = src[i];
+
+        AT24Cxx_BARRIER();
+        if (sh->seq == seq) return 0;
+    }
+
+    return 1;
+}
+/**
+ * @brief  AT24Cxx shadow write (spare RAM copy, EEPROM, then publish)
+ * @param  {AT24Cxx_SHADOW_t} *sh : shadow pointer
+ * @param  {uint32_t} offset      : offset in the range
+ * @param  {const void} *data     : write data pointer
+ * @param  {uint32_t} size        : write data size
+ * @return {uint8_t}              : 0 --- success
+ *                                  1 --- error (out of range or bus error)
+ *                                  AT24Cxx_ETIMEOUT --- write cycle timeout
+ * @note   Writers must be serialized. The new data is built in the spare copy
+ *         and published once the EEPROM holds it; on error readers keep the
+ *         previous data, while the EEPROM range may be partially written and
+ *         is brought back in line by the next successful write of it.
+ */
+uint8_t AT24Cxx_Shadow_Write(AT24Cxx_SHADOW_t *sh, uint32_t offset, const void *data, uint32_t size)
+{
+    uint8_t *cur, *spare;
+    uint32_t seq;
+    uint8_t rsp;
+
+    if (offset > sh->size || size > sh->size - offset) return 1;
+
+    seq = sh->seq;
+    cur = (uint8_t *)sh->ram + (seq & 1) * sh->size;
+    spare = (uint8_t *)sh->ram + ((seq + 1) & 1) * sh->size;
+
+    memcpy(spare, cur, sh->size);
+    memcpy(spare + offset, data, size);
+
+    rsp = AT24Cxx_Write(sh->dev, sh->addr + offset, spare + offset, size);
+    if (rsp != 0) return rsp;
+
+    /* Spare copy is complete before it is published */
+    AT24Cxx_BARRIER();
+    sh->seq = seq + 1;
+
+    return 0;
+}
+/*------------------------------------------------------*/
+/*             AT24Cxx Asynchronous Function            */
+/*------------------------------------------------------*/
+/**
+ * @brief  AT24Cxx start asynchronous operation
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint8_t} type     : AT24Cxx_OPTYPE
+ * @param  {uint32_t} saddr   : start address
+ * @param  {uint8_t} *data    : data pointer
+ * @param  {uint8_t} fdata    : filling data
+ * @param  {uint32_t} size    : data size
+ * @return {uint8_t}          : 0 --- success
+ *                              1 --- error (operation still in flight)
+ * @note   none
+ */
+static uint8_t AT24Cxx_Async_Start(AT24Cxx_OP_t *op, at24cxx_t *dev, uint8_t type, uint32_t saddr, uint8_t *data, uint8_t fdata, uint32_t size)
+{
+    if (op->state == AT24Cxx_OP_BUSY || op->state == AT24Cxx_OP_WAIT) return 1;
+
+    op->dev = dev;
+    op->type = type;
+    op->fdata = fdata;
+    op->addr = saddr;
+    op->data = data;
+    op->remain = size;
+    op->start = saddr;
+    op->end = saddr + size;
+    op->cancel = 0;
+    op->state = AT24Cxx_OP_BUSY;
+
+#if AT24Cxx_DEFER_PAGES != 0
+
+    if (type == AT24Cxx_OP_WRITE || type == AT24Cxx_OP_ERASE) AT24Cxx_Defer_Drop(dev, saddr, size);
+
+#endif
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx finish asynchronous operation
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @param  {uint8_t} state    : AT24Cxx_OP_DONE, ERROR, CANCEL, MISMATCH or TIMEOUT
+ * @return none
+ * @note   none
+ */
+static void AT24Cxx_Async_Finish(AT24Cxx_OP_t *op, uint8_t state)
+{
+    op->state = state;
+
+    if (op->done != NULL) op->done(op);
+}
+/**
+ * @brief  AT24Cxx write cycle completion source of asynchronous operation
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @return {uint8_t}          : 1 --- acknowledge polling
+ *                              0 --- AT24Cxx_Async_Resume
+ * @note   A pending lazy write cycle is always polled, it has no timer callback.
+ */
+static uint8_t AT24Cxx_Async_Polled(AT24Cxx_OP_t *op)
+{
+#if AT24Cxx_LAZY_WCYCLE != 0
+    if (op->dev->pend != NULL && op->dev->pend->busy) return 1;
+#endif
+    (void)op;
+    return AT24Cxx_ASYNC_ACKPOLL != 0;
+}
+/**
+ * @brief  AT24Cxx start asynchronous read
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint32_t} saddr   : start address
+ * @param  {uint8_t} *data    : read data pointer
+ * @param  {uint32_t} size    : read data size
+ * @return {uint8_t}          : 0 --- success
+ *                              1 --- error
+ * @note   op->done and op->arg are kept, set them before start
+ */
+uint8_t AT24Cxx_Async_Read(AT24Cxx_OP_t *op, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+{
+    return AT24Cxx_Async_Start(op, dev, AT24Cxx_OP_READ, saddr, data, 0, size);
+}
+/**
+ * @brief  AT24Cxx start asynchronous write
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint32_t} saddr   : start address
+ * @param  {uint8_t} *data    : write data pointer (must stay valid until done)
+ * @param  {uint32_t} size    : write data size
+ * @return {uint8_t}          : 0 --- success
+ *                              1 --- error
+ * @note   op->done and op->arg are kept, set them before start
+ */
+uint8_t AT24Cxx_Async_Write(AT24Cxx_OP_t *op, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+{
+    return AT24Cxx_Async_Start(op, dev, AT24Cxx_OP_WRITE, saddr, data, 0, size);
+}
+/**
+ * @brief  AT24Cxx start asynchronous erase
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint32_t} saddr   : start address
+ * @param  {uint8_t} fdata    : filling data (0x00 - 0xFF)
+ * @param  {uint32_t} size    : erase data size
+ * @return {uint8_t}          : 0 --- success
+ *                              1 --- error
+ * @note   op->done and op->arg are kept, set them before start
+ */
+uint8_t AT24Cxx_Async_Erase(AT24Cxx_OP_t *op, at24cxx_t *dev, uint32_t saddr, uint8_t fdata, uint32_t size)
+{
+    return AT24Cxx_Async_Start(op, dev, AT24Cxx_OP_ERASE, saddr, NULL, fdata, size);
+}
+/**
+ * @brief  AT24Cxx start asynchronous verify
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint32_t} saddr   : start address
+ * @param  {uint8_t} *data    : expected data pointer (NULL : every byte is fdata)
+ * @param  {uint8_t} fdata    : expected filling data of a blank check
+ * @param  {uint32_t} size    : verify data size
+ * @return {uint8_t}          : 0 --- success
+ *                              1 --- error
+ * @note   The memory is compared, not the page cache or staged writes. A
+ *         difference finishes with AT24Cxx_OP_MISMATCH and op->addr at the
+ *         first differing byte.
+ */
+uint8_t AT24Cxx_Async_Verify(AT24Cxx_OP_t *op, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint8_t fdata, uint32_t size)
+{
+    return AT24Cxx_Async_Start(op, dev, AT24Cxx_OP_VERIFY, saddr, data, fdata, size);
+}
+/**
+ * @brief  AT24Cxx cancel asynchronous operation
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @return none
+ * @note   The operation stops before its next transfer, a page being programmed
+ *         completes its write cycle first. Safe to call from ISR.
+ */
+void AT24Cxx_Async_Cancel(AT24Cxx_OP_t *op)
+{
+    op->cancel = 1;
+}
+/**
+ * @brief  AT24Cxx write cycle completion of asynchronous operation
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @return none
+ * @note   Completion source when AT24Cxx_ASYNC_ACKPOLL is 0, call from a timer
+ *         callback at least 5ms after the page program. Safe to call from ISR.
+ */
+void AT24Cxx_Async_Resume(AT24Cxx_OP_t *op)
+{
+    if (op->state == AT24Cxx_OP_WAIT)
+    {
+        op->state = AT24Cxx_OP_BUSY;
+    }
+}
+/**
+ * @brief  AT24Cxx advance asynchronous operation
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @return {AT24Cxx_OPSTATE}  : operation state after this step
+ * @note   Each call performs at most one bus transfer (one page program, one
+ *         page-sized read or one acknowledge poll) and never waits for the
+ *         self-timed write cycle. Operations on different devices may be
+ *         polled in turn from one loop.
+ */
+AT24Cxx_OPSTATE AT24Cxx_Async_Poll(AT24Cxx_OP_t *op)
+{
+    uint8_t compare_data[AT24Cxx_MAX_COMPARE_SIZE];
+    uint16_t size, j;
+    uint8_t rsp = 0;
+
+#if AT24Cxx_LAZY_WCYCLE != 0
+    /* Lazy write cycle left by a blocking write, poll it instead of waiting in the transfer */
+    if (op->state == AT24Cxx_OP_BUSY && op->remain != 0 && op->dev->pend != NULL && op->dev->pend->busy)
+    {
+        op->state = AT24Cxx_OP_WAIT;
+        op->stamp = AT24CXX_GETTICK();
+    }
+#endif
+
+    /* Self-timed Write cycle */
+    if (op->state == AT24Cxx_OP_WAIT)
+    {
+#if AT24Cxx_ASYNC_ACKPOLL != 0 || AT24Cxx_LAZY_WCYCLE != 0
+        if (AT24Cxx_Async_Polled(op))
+        {
+            if (AT24Cxx_AckPoll(op->dev) == 0)
+            {
+                op->state = AT24Cxx_OP_BUSY;
+#if AT24Cxx_LAZY_WCYCLE != 0
+                if (op->dev->pend != NULL) op->dev->pend->busy = 0;
+#endif
+            }
+#if AT24Cxx_TIMEOUT_MS != 0
+            else if (AT24Cxx_Expired(op->dev, op->stamp))
+            {
+                AT24Cxx_Release(op->dev);
+                AT24Cxx_Async_Finish(op, AT24Cxx_OP_TIMEOUT);
+                return (AT24Cxx_OPSTATE)op->state;
+            }
+#endif
+        }
+#endif
+        if (op->state == AT24Cxx_OP_WAIT || op->remain != 0) return (AT24Cxx_OPSTATE)op->state;
+    }
+
+    if (op->state != AT24Cxx_OP_BUSY) return (AT24Cxx_OPSTATE)op->state;
+
+    if (op->remain == 0)
+    {
+        AT24Cxx_Async_Finish(op, AT24Cxx_OP_DONE);
+        return (AT24Cxx_OPSTATE)op->state;
+    }
+
+    if (op->cancel)
+    {
+        AT24Cxx_Async_Finish(op, AT24Cxx_OP_CANCEL);
+        return (AT24Cxx_OPSTATE)op->state;
+    }
+
+    if (op->type == AT24Cxx_OP_READ)
+    {
+        /* Read one page at a time */
+        size = (uint16_t)min(op->remain, (uint32_t)op->dev->info.pagesize);
+        rsp = AT24Cxx_Read(op->dev, op->addr, op->data, size);
+    }
+    else if (op->type == AT24Cxx_OP_VERIFY)
+    {
+        /* Compare at most AT24Cxx_MAX_COMPARE_SIZE, never across a page */
+        size = (uint16_t)min(op->remain, op->dev->info.pagesize - op->addr % op->dev->info.pagesize);
+        size = (uint16_t)min(size, AT24Cxx_MAX_COMPARE_SIZE);
+        rsp = AT24Cxx_Fetch(op->dev, op->addr, compare_data, size);
+        for (j = 0; j < size && rsp == 0; j++)
+        {
+            if (compare_data[j] != (op->data != NULL ? op->data[j] : op->fdata))
+            {
+                op->addr += j;
+                op->remain -= j;
+                if (op->data != NULL) op->data += j;
+                AT24Cxx_Async_Finish(op, AT24Cxx_OP_MISMATCH);
+                return (AT24Cxx_OPSTATE)op->state;
+            }
+        }
+    }
+    else
+    {
+        /* Program one page, then wait for the write cycle */
+        size = AT24Cxx_ProgramSize(op->dev, op->addr, op->remain, op->type == AT24Cxx_OP_ERASE);
+        rsp = AT24Cxx_Program(op->dev, op->addr, op->data, op->fdata, size);
+        op->stamp = AT24CXX_GETTICK();
+        if (rsp == 0) op->state = AT24Cxx_OP_WAIT;
+    }
+
+    if (rsp != 0)
+    {
+        AT24Cxx_Async_Finish(op, AT24Cxx_OP_ERROR);
+        return (AT24Cxx_OPSTATE)op->state;
+    }
+
+    /* Update progress, read data is in RAM before its address is published */
+    AT24Cxx_BARRIER();
+    op->addr += size;
+    op->remain -= size;
+    if (op->data != NULL) op->data += size;
+
+    /* Reads finish immediately, programs after the last write cycle */
+    if (op->remain == 0 && op->state == AT24Cxx_OP_BUSY)
+    {
+        AT24Cxx_Async_Finish(op, AT24Cxx_OP_DONE);
+    }
+
+    return (AT24Cxx_OPSTATE)op->state;
+}
+/**
+ * @brief  AT24Cxx advance asynchronous operation within a budget
+ * @param  {AT24Cxx_OP_t} *op : operation handle
+ * @param  {uint16_t} pages   : maximum number of page transfers (0 : no limit)
+ * @param  {uint16_t} polls   : maximum number of write cycle acknowledge polls (0 : no limit)
+ * @return {AT24Cxx_OPSTATE}  : operation state on return
+ * @note   Polls until the operation finishes or the budget is used, progress is
+ *         kept in op->addr and op->remain. The budget is counted in bus transfers
+ *         rather than measured, so a slice is bounded without a tick source: at
+ *         most pages page transfers plus polls one byte address transfers. With
+ *         AT24Cxx_ASYNC_ACKPOLL set to 0 it also returns on a write cycle that
+ *         is not polled.
+ */
+AT24Cxx_OPSTATE AT24Cxx_Async_Run(AT24Cxx_OP_t *op, uint16_t pages, uint16_t polls)
+{
+    uint32_t remain;
+
+    while (op->state == AT24Cxx_OP_BUSY || op->state == AT24Cxx_OP_WAIT)
+    {
+        if (op->state == AT24Cxx_OP_WAIT && !AT24Cxx_Async_Polled(op)) break;
+
+        remain = op->remain;
+        AT24Cxx_Async_Poll(op);
+        if (op->remain != remain)
+        {
+            if (pages != 0 && --pages == 0) break;
+        }
+        else
+        {
+            if (polls != 0 && --polls == 0) break;
+        }
+    }
+
+    return (AT24Cxx_OPSTATE)op->state;
+}
+/**
+ * @brief  AT24Cxx check preloaded bytes of an asynchronous read
+ * @param  {AT24Cxx_OP_t} *op : read operation handle
+ * @param  {uint32_t} addr    : EEPROM address (inside the read range)
+ * @param  {uint32_t} size    : byte count
+ * @return {uint8_t}          : 0 --- bytes are in RAM
+ *                              1 --- not yet, the read stopped before them, or
+ *                                    the range is outside the read
+ * @note   Pages are read in order, so a range is available as soon as the read
+ *         has passed it. Safe to call while the read is polled from an ISR.
+ */
+uint8_t AT24Cxx_Async_Ready(AT24Cxx_OP_t *op, uint32_t addr, uint32_t size)
+{
+    if (op->type != AT24Cxx_OP_READ) return 1;
+    if (addr < op->start || addr > op->end || size > op->end - addr) return 1;
+    if (op->state != AT24Cxx_OP_DONE && addr + size > op->addr) return 1;
+
+    /* The caller reads the data only after the progress it was published with */
+    AT24Cxx_BARRIER();
+
+    return 0;
+}
+/**
+ * @brief  AT24Cxx wait for preloaded bytes of an asynchronous read
+ * @param  {AT24Cxx_OP_t} *op : read operation handle
+ * @param  {uint32_t} addr    : EEPROM address (inside the read range)
+ * @param  {uint32_t} size    : byte count
+ * @return {uint8_t}          : 0 --- bytes are in RAM
+ *                              1 --- error (read failed or cancelled before them,
+ *                                    or range outside the read)
+ * @note   Polls the read until it has passed the range, later pages are left
+ *         to the background. Do not use while the read is polled from an ISR.
+ */
+uint8_t AT24Cxx_Async_Wait(AT24Cxx_OP_t *op, uint32_t addr, uint32_t size)
+{
+    while (AT24Cxx_Async_Ready(op, addr, size))
+    {
+        if (op->type != AT24Cxx_OP_READ || op->state != AT24Cxx_OP_BUSY) return 1;
+        if (addr < op->start || addr > op->end || size > op->end - addr) return 1;
+        AT24Cxx_Async_Poll(op);
+    }
+
+    return 0;
+}
+/*------------------------------------------------------*/
+/*                 AT24Cxx Gang Function                */
+/*------------------------------------------------------*/
+/* Drive active lanes, keep the other lanes released */
+#define GANG_SCL(g, act, lvl)       (g)->set_scl((lvl) ? 0xFFFFFFFFUL : ~(act))
+#define GANG_SDA(g, act, lvl)       (g)->set_sda((lvl) ? 0xFFFFFFFFUL : ~(act))
+/**
+ * @brief  Gang i2c start condition
+ * @param  {AT24Cxx_GANG_t} *g : multi-lane port
+ * @param  {uint32_t} act      : active lanes
+ * @return none
+ * @note   SCL low on return
+ */
+static void AT24Cxx_Gang_Start(AT24Cxx_GANG_t *g, uint32_t act)
+{
+    GANG_SDA(g, act, 1);
+    GANG_SCL(g, act, 1);
+    g->holdtime(1);
+    GANG_SDA(g, act, 0);
+    g->holdtime(1);
+    GANG_SCL(g, act, 0);
+}
+/**
+ * @brief  Gang i2c stop condition
+ * @param  {AT24Cxx_GANG_t} *g : multi-lane port
+ * @param  {uint32_t} act      : active lanes
+ * @return none
+ * @note   none
+ */
+static void AT24Cxx_Gang_Stop(AT24Cxx_GANG_t *g, uint32_t act)
+{
+    GANG_SDA(g, act, 0);
+    g->holdtime(1);
+    GANG_SCL(g, act, 1);
+    g->holdtime(1);
+    GANG_SDA(g, act, 1);
+    g->holdtime(1);
+}
+/**
+ * @brief  Gang drop lanes from the transfer
+ * @param  {AT24Cxx_GANG_t} *g : multi-lane port
+ * @param  {uint32_t} act      : active lanes (SCL low)
+ * @param  {uint32_t} drop     : lanes to drop (NACK seen or sent, SDA released)
+ * @return {uint32_t}          : remaining active lanes
+ * @note   The dropped lanes get a stop condition, SCL of the remaining lanes
+ *         stays low so they see no clock.
+ */
+static uint32_t AT24Cxx_Gang_Drop(AT24Cxx_GANG_t *g, uint32_t act, uint32_t drop)
+{
+    drop &= act;
+    if (drop == 0) return act;
+    act &= ~drop;
+
+    g->set_sda(~drop);
+    g->holdtime(1);
+    g->set_scl(~act);
+    g->holdtime(1);
+    g->set_sda(0xFFFFFFFFUL);
+    g->holdtime(1);
+
+    return act;
+}
+/**
+ * @brief  Gang i2c write one byte
+ * @param  {AT24Cxx_GANG_t} *g : multi-lane port
+ * @param  {uint32_t} act      : active lanes
+ * @param  {uint8_t} byte      : byte to send (MSB first)
+ * @return {uint32_t}          : lanes that did not acknowledge
+ * @note   none
+ */
+static uint32_t AT24Cxx_Gang_WByte(AT24Cxx_GANG_t *g, uint32_t act, uint8_t byte)
+{
+    uint8_t i;
+    uint32_t nack;
+
+    for (i = 0; i < 8; i++)
+    {
+        GANG_SDA(g, act, byte & 0x80);
+        byte <<= 1;
+        g->holdtime(1);
+        GANG_SCL(g, act, 1);
+        g->holdtime(1);
+        GANG_SCL(g, act, 0);
+    }
+
+    /* Acknowledge clock */
+    GANG_SDA(g, act, 1);
+    g->holdtime(1);
+    GANG_SCL(g, act, 1);
+    g->holdtime(1);
+    nack = g->get_sda() & act;
+    GANG_SCL(g, act, 0);
+
+    return nack;
+}
+/**
+ * @brief  Gang i2c read one byte and compare it on every lane
+ * @param  {AT24Cxx_GANG_t} *g : multi-lane port
+ * @param  {uint32_t} act      : active lanes
+ * @param  {uint8_t} expect    : expected byte
+ * @param  {uint8_t} last      : 1 --- last byte (NACK)
+ * @return {uint32_t}          : lanes whose byte differs
+ * @note   Lanes whose byte differs get a NACK, so they release SDA for the stop
+ */
+static uint32_t AT24Cxx_Gang_RByte(AT24Cxx_GANG_t *g, uint32_t act, uint8_t expect, uint8_t last)
+{
+    uint8_t i;
+    uint32_t diff = 0;
+
+    GANG_SDA(g, act, 1);
+    for (i = 0; i < 8; i++)
+    {
+        g->holdtime(1);
+        GANG_SCL(g, act, 1);
+        g->holdtime(1);
+        diff |= (g->get_sda() ^ ((expect & 0x80) ? 0xFFFFFFFFUL : 0)) & act;
+        expect <<= 1;
+        GANG_SCL(g, act, 0);
+    }
+
+    /* Acknowledge clock */
+    GANG_SDA(g, act & ~diff, last);
+    g->holdtime(1);
+    GANG_SCL(g, act, 1);
+    g->holdtime(1);
+    GANG_SCL(g, act, 0);
+    GANG_SDA(g, act, 1);
+
+    return diff;
+}
+/**
+ * @brief  Gang send device address and word address
+ * @param  {AT24Cxx_GANG_t} *g : multi-lane port
+ * @param  {uint32_t} act      : active lanes
+ * @param  {at24cxx_t} *dev    : device template (type and address of every lane)
+ * @param  {uint32_t} addr     : word address
+ * @return {uint32_t}          : remaining active lanes
+ * @note   Lanes that do not acknowledge are dropped
+ */
+static uint32_t AT24Cxx_Gang_Address(AT24Cxx_GANG_t *g, uint32_t act, at24cxx_t *dev, uint32_t addr)
+{
+    uint8_t memaddr_size = 1;
+    uint8_t devaddr = AT24Cxx_GetDevAddress(dev, addr, &memaddr_size);
+
+    AT24Cxx_Gang_Start(g, act);
+    act = AT24Cxx_Gang_Drop(g, act, AT24Cxx_Gang_WByte(g, act, (uint8_t)(devaddr & 0xFE)));
+    if (memaddr_size == 2)
+    {
+        act = AT24Cxx_Gang_Drop(g, act, AT24Cxx_Gang_WByte(g, act, (uint8_t)(addr >> 8)));
+    }
+    act = AT24Cxx_Gang_Drop(g, act, AT24Cxx_Gang_WByte(g, act, (uint8_t)addr));
+
+    return act;
+}
+/**
+ * @brief  Gang wait until the self-timed write cycle of every lane is over
+ * @param  {AT24Cxx_GANG_t} *g : multi-lane port
+ * @param  {uint32_t} act      : active lanes
+ * @param  {at24cxx_t} *dev    : device template (address and timeout)
+ * @return {uint32_t}          : lanes that finished in time
+ * @note   Acknowledge polling of the busy lanes bounded by the device timeout,
+ *         or the fixed delay
+ */
+static uint32_t AT24Cxx_Gang_Wait(AT24Cxx_GANG_t *g, uint32_t act, at24cxx_t *dev)
+{
+#if AT24Cxx_TIMEOUT_MS != 0
+
+    uint32_t start = AT24CXX_GETTICK();
+    uint32_t busy = act, poll;
+
+    while (busy != 0)
+    {
+        /* IIC start, send i2c address, IIC stop */
+        poll = busy;
+        AT24Cxx_Gang_Start(g, poll);
+        busy = AT24Cxx_Gang_WByte(g, poll, (uint8_t)(dev->info.i2caddr.byte & 0xFE));
+        AT24Cxx_Gang_Stop(g, poll);
+
+        if (busy != 0 && AT24Cxx_Expired(dev, start)) return act & ~busy;
+    }
+
+#else
+
+    (void)g;
+    (void)dev;
+    AT24CXX_WCYCLEMS;
+
+#endif
+
+    return act;
+}
+/**
+ * @brief  AT24Cxx gang write identical data to the chips of all lanes
+ * @param  {AT24Cxx_GANG_t} *gang : multi-lane port
+ * @param  {at24cxx_t} *dev       : device template (type and address of every lane)
+ * @param  {uint32_t} saddr       : start address
+ * @param  {uint8_t} *data        : write data pointer
+ * @param  {uint32_t} size        : write data size
+ * @return {uint32_t}             : failed lanes (0 --- all lanes success)
+ * @note   A lane that misses an acknowledge, or whose write cycle does not end
+ *         within the device timeout, gets a stop condition and is dropped, the
+ *         other lanes go on. N chips are programmed in the time of one.
+ */
+uint32_t AT24Cxx_Gang_Write(AT24Cxx_GANG_t *gang, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+{
+    uint32_t i, j;
+    uint32_t RemainSize = size;
+    uint32_t EndAddr = saddr + size;
+    uint32_t act = gang->lanes;
+
+    for (i = saddr; i < EndAddr && act != 0; i += size)
+    {
+        /* Current write size, Update remaining size */
+        size = AT24Cxx_ProgramSize(dev, i, RemainSize, 0);
+        RemainSize -= size;
+
+        /* Address, data */
+        act = AT24Cxx_Gang_Address(gang, act, dev, i);
+        for (j = 0; j < size; j++)
+        {
+            act = AT24Cxx_Gang_Drop(gang, act, AT24Cxx_Gang_WByte(gang, act, data[j]));
+        }
+        data += size;
+
+        AT24Cxx_Gang_Stop(gang, act);
+
+        /* Self-timed Write cycle */
+        act = AT24Cxx_Gang_Wait(gang, act, dev);
+    }
+
+    return gang->lanes & ~act;
+}
+/**
+ * @brief  AT24Cxx gang compare the chips of all lanes with data
+ * @param  {AT24Cxx_GANG_t} *gang : multi-lane port
+ * @param  {at24cxx_t} *dev       : device template (type and address of every lane)
+ * @param  {uint32_t} saddr       : start address
+ * @param  {uint8_t} *data        : expected data pointer
+ * @param  {uint32_t} size        : data size
+ * @return {uint32_t}             : failed lanes (0 --- all lanes match)
+ * @note   All lanes are read in one sequential read, each bit is compared per lane
+ */
+uint32_t AT24Cxx_Gang_Verify(AT24Cxx_GANG_t *gang, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size)
+{
+    uint32_t i;
+    uint32_t act = gang->lanes;
+    uint8_t devaddr;
+
+    if (size == 0) return 0;
+
+    /* Word address, then repeated start in read mode */
+    act = AT24Cxx_Gang_Address(gang, act, dev, saddr);
+    devaddr = dev->info.i2caddr.byte;
+    AT24Cxx_Gang_Start(gang, act);
+    act = AT24Cxx_Gang_Drop(gang, act, AT24Cxx_Gang_WByte(gang, act, (uint8_t)(devaddr | 0x01)));
+
+    for (i = 0; i < size && act != 0; i++)
+    {
+        act = AT24Cxx_Gang_Drop(gang, act, AT24Cxx_Gang_RByte(gang, act, data[i], (i == size - 1) ? 1 : 0));
+    }
+
+    AT24Cxx_Gang_Stop(gang, act);
+
+    return gang->lanes & ~act;
+}
 
 
 
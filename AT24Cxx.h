@@ -22,10 +22,31 @@
  *   01-12-2023        iammingge                Initial Version 1.0
  *   18-06-2023        iammingge                1. Support software i2c to drive device
  *											    2. Support hardware i2c to drive device
+ *   18-10-2026        iammingge                1. Add record layout planner
+ *                                              2. Add compile-time record map
+ *                                              3. Add persistent variables
+ *                                              4. Add asynchronous read/write/erase
+ *                                              5. Add static arena for driver buffers
+ *                                              6. Add AT24Cxx_GetDevAddress for port transfers
+ *                                              7. Add open-drain software i2c mode
+ *                                              8. Add multi-lane gang write
+ *                                              9. Configuration macros can be set by the build
+ *                                              10. Fix AT24Cxx_Readback_Write beyond 2550 bytes, 32-bit address and size
+ *                                              11. Add set-associative page cache
+ *                                              12. Add double-buffered shadow for interrupt readers
+ *                                              13. Add lazy write cycle with reads served from the programmed page
+ *                                              14. Add deferred writes flushed at idle time
+ *                                              15. Add write transactions with optional journal
+ *                                              16. Add cancel, transfer budget and verify to asynchronous operations
+ *                                              17. Add write cycle timeouts with bus release
+ *                                              18. Add preload wait on asynchronous reads
+ *                                              19. Add packed boot region of persistent variables
+ *                                              20. Add versioned records with lazy migration
 **/
 #ifndef __AT24CXX_H
 #define __AT24CXX_H
 #include "bus_i2c.h"
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,29 +63,161 @@ extern "C" {
  * 0 : software
  * 1 : hardware
  */
+#ifndef AT24Cxx_I2C_MODE
 #define	AT24Cxx_I2C_MODE			1
+#endif
+
+/**
+ * @brief AT24Cxx software i2c open-drain mode (AT24Cxx_I2C_MODE 0 only)
+ * 0 : bus_i2c bit-bang routines (SDA direction switched by sda_mode)
+ * 1 : SDA and SCL are open-drain outputs configured by the user, the driver
+ *     bit-bangs with set_scl/set_sda/get_sda/holdtime only and reads the SDA
+ *     pin while it is released, sda_mode/scl_mode are never called
+ */
+#ifndef AT24Cxx_SW_OPENDRAIN
+#define AT24Cxx_SW_OPENDRAIN        0
+#endif
 
 /**
  * @brief Erase maximum length at one time
  */
+#ifndef AT24Cxx_MAX_ERASE_SIZE
 #define AT24Cxx_MAX_ERASE_SIZE		10
+#endif
+
+/**
+ * @brief Static arena size for all driver buffers (byte)
+ * Optional subsystem buffers are allocated from it at init,
+ * use AT24Cxx_Arena_Report to read the worst-case usage.
+ */
+#ifndef AT24Cxx_ARENA_SIZE
+#define AT24Cxx_ARENA_SIZE          256
+#endif
 
 /**
  * @brief Once compare size in Readback Write
  */
+#ifndef AT24Cxx_MAX_COMPARE_SIZE
 #define AT24Cxx_MAX_COMPARE_SIZE    10
+#endif
 
 /**
  * @brief Self-timed Write cycle (5ms max)
  * The delay function in the stm32 HAL library function is inaccurate and may be
  * affected by other peripheral library functions with timeout function. (HAL_Delay)
  */
+#ifndef AT24CXX_WCYCLEMS
 #define AT24CXX_WCYCLEMS            do { \
                                         /*------ User add 5ms delay ------*/ \
                                         uint32_t time = 80000; \
                                         do {} while (time--); \
                                         /*--------------------------------*/ \
                                     } while (0);
+#endif
+
+/**
+ * @brief Asynchronous write cycle completion source
+ * 0 : AT24Cxx_Async_Resume (timer or DMA callback)
+ * 1 : acknowledge polling in AT24Cxx_Async_Poll
+ */
+#ifndef AT24Cxx_ASYNC_ACKPOLL
+#define AT24Cxx_ASYNC_ACKPOLL       1
+#endif
+
+/**
+ * @brief Write cycle timeout (ms, 0 : fixed AT24CXX_WCYCLEMS wait)
+ * Non-zero waits for write cycles by acknowledge polling, measured with
+ * AT24CXX_GETTICK. A device still busy after its timeout (AT24Cxx_SetTimeout)
+ * fails with AT24Cxx_ETIMEOUT and the bus is released.
+ */
+#ifndef AT24Cxx_TIMEOUT_MS
+#define AT24Cxx_TIMEOUT_MS          0
+#endif
+
+/**
+ * @brief Release a hung hardware i2c bus after a timeout
+ */
+#ifndef AT24CXX_HW_RELEASE
+#define AT24CXX_HW_RELEASE(bus)     ((void)(bus))   /* User add bus recovery (e.g. peripheral reset) */
+#endif
+
+/**
+ * @brief Return code of a timed out transfer (0 --- success, 1 --- error)
+ */
+#define AT24Cxx_ETIMEOUT            2
+
+/**
+ * @brief Page cache in front of AT24Cxx_Read (0 sets : no cache)
+ * Each device with AT24Cxx_Cache_Init gets SETS * WAYS page lines from the arena,
+ * page n lives in set (n % SETS), LRU within the set.
+ */
+#ifndef AT24Cxx_CACHE_SETS
+#define AT24Cxx_CACHE_SETS          0
+#endif
+#ifndef AT24Cxx_CACHE_WAYS
+#define AT24Cxx_CACHE_WAYS          4
+#endif
+
+/**
+ * @brief Lazy write cycle (0 : Write and Erase always wait, 1 : AT24Cxx_Lazy_Init available)
+ * The wait of the last page program moves to the next access of the device.
+ */
+#ifndef AT24Cxx_LAZY_WCYCLE
+#define AT24Cxx_LAZY_WCYCLE         0
+#endif
+
+/**
+ * @brief Deferred write staging pages (0 : Write programs immediately)
+ * AT24Cxx_Defer_Init stages writes in RAM pages, AT24Cxx_Defer_Idle programs them.
+ */
+#ifndef AT24Cxx_DEFER_PAGES
+#define AT24Cxx_DEFER_PAGES         0
+#endif
+
+/**
+ * @brief System tick for write cycle timeouts and deferred write latency
+ * Write cycle timeouts cannot expire on the default constant tick.
+ */
+#ifndef AT24CXX_GETTICK
+#if AT24Cxx_TIMEOUT_MS != 0
+#error "AT24Cxx_TIMEOUT_MS needs a tick source, define AT24CXX_GETTICK() (e.g. HAL_GetTick())"
+#endif
+#define AT24CXX_GETTICK()           0               /* User add tick source (e.g. HAL_GetTick()) */
+#endif
+#ifndef AT24Cxx_TICK_FREQ
+#define AT24Cxx_TICK_FREQ           1000            /* tick frequency (Hz) */
+#endif
+
+/**
+ * @brief Maximum time a write stays staged (ms)
+ */
+#ifndef AT24Cxx_DEFER_LATENCY_MS
+#define AT24Cxx_DEFER_LATENCY_MS    1000
+#endif
+#define AT24Cxx_DEFER_LATENCY       ((uint32_t)((uint64_t)AT24Cxx_DEFER_LATENCY_MS * AT24Cxx_TICK_FREQ / 1000))
+
+/**
+ * @brief Shadow read attempts before AT24Cxx_Shadow_Read gives up
+ * A reader on the writer's core (e.g. an ISR) always succeeds at the first
+ * attempt. Only a reader on another core can see the writer publish twice
+ * while it copies, and retries a bounded number of times instead of spinning.
+ */
+#ifndef AT24Cxx_SHADOW_RETRY
+#define AT24Cxx_SHADOW_RETRY        3
+#endif
+
+/**
+ * @brief Memory barrier of the shadow sequence lock
+ * Compiler barrier by default (single core), use a hardware barrier on multi-core
+ * parts (e.g. __DMB() or __sync_synchronize()).
+ */
+#ifndef AT24Cxx_BARRIER
+#if defined(__GNUC__)
+#define AT24Cxx_BARRIER()           __asm volatile ("" ::: "memory")
+#else
+#define AT24Cxx_BARRIER()
+#endif
+#endif
 
 /**
  * @brief AT24Cxx Type
@@ -85,6 +238,20 @@ typedef enum
     AT24CM02 = 0x0C
 } AT24Cxx_CHIP;
 
+/**
+ * @brief AT24Cxx chip capacity (byte)
+ */
+#define AT24Cxx_CAPACITY(type)      (128UL << ((type) - 1))
+
+/**
+ * @brief AT24Cxx chip page write size (byte)
+ */
+#define AT24Cxx_PAGESIZE(type)      ((int)(type) <= (int)AT24C02  ? 0x08 : \
+                                     (int)(type) <= (int)AT24C16  ? 0x10 : \
+                                     (int)(type) <= (int)AT24C64  ? 0x20 : \
+                                     (int)(type) <= (int)AT24C256 ? 0x40 : \
+                                     (int)(type) == (int)AT24C512 ? 0x80 : 0x100)
+
 /**
  * @brief AT24Cxx Device Info
  */
@@ -129,6 +296,53 @@ typedef struct
 #endif
 } AT24Cxx_PORT_t;
 
+/**
+ * @brief AT24Cxx Page Cache
+ */
+#if AT24Cxx_CACHE_SETS != 0
+typedef struct
+{
+    uint32_t tag[AT24Cxx_CACHE_SETS * AT24Cxx_CACHE_WAYS];  /* page + 1, 0 --- invalid */
+    uint32_t use[AT24Cxx_CACHE_SETS * AT24Cxx_CACHE_WAYS];  /* last use (LRU) */
+    uint32_t clock;                 /* use counter */
+    uint32_t hits;                  /* pages served from the cache */
+    uint32_t misses;                /* pages read from the device */
+    uint8_t *line;                  /* lines of one page each */
+} AT24Cxx_CACHE_t;
+#endif
+
+/**
+ * @brief AT24Cxx Pending Write Cycle
+ */
+#if AT24Cxx_LAZY_WCYCLE != 0
+typedef struct
+{
+    uint8_t busy;                   /* write cycle may be in progress */
+    uint16_t size;                  /* programmed size (0 --- nothing to serve) */
+    uint32_t addr;                  /* programmed address */
+    uint8_t *data;                  /* programmed bytes (one page) */
+} AT24Cxx_PEND_t;
+#endif
+
+/**
+ * @brief AT24Cxx Deferred Write Staging
+ */
+#if AT24Cxx_DEFER_PAGES != 0
+#define AT24Cxx_DEFER_MAPSIZE       32              /* staged byte map per page (256 byte pages) */
+
+typedef struct
+{
+    uint32_t tag[AT24Cxx_DEFER_PAGES];      /* page + 1, 0 --- free */
+    uint32_t stamp[AT24Cxx_DEFER_PAGES];    /* tick of the first staged write */
+    uint8_t dirty[AT24Cxx_DEFER_PAGES * AT24Cxx_DEFER_MAPSIZE];  /* bit n : byte n staged */
+    uint8_t *data;                          /* staged pages */
+    uint8_t txn;                            /* transaction open */
+    uint8_t sealed;                         /* journal of the open transaction is sealed */
+    uint32_t jaddr;                         /* transaction journal address */
+    uint32_t jsize;                         /* transaction journal size, 0 --- none */
+} AT24Cxx_DEFER_t;
+#endif
+
 /**
  * @brief AT24Cxx Device Struct
  */
@@ -136,20 +350,312 @@ typedef struct
 {
     AT24Cxx_INFO_t info;
     AT24Cxx_PORT_t port;
+#if AT24Cxx_CACHE_SETS != 0
+    AT24Cxx_CACHE_t *cache;         /* page cache (NULL --- none) */
+#endif
+#if AT24Cxx_LAZY_WCYCLE != 0
+    AT24Cxx_PEND_t *pend;           /* lazy write cycle (NULL --- blocking) */
+#endif
+#if AT24Cxx_DEFER_PAGES != 0
+    AT24Cxx_DEFER_t *defer;         /* staging buffer (NULL --- none) */
+#endif
+#if AT24Cxx_TIMEOUT_MS != 0
+    uint16_t timeout;               /* write cycle timeout (ms) */
+#endif
 } at24cxx_t;
 
+/**
+ * @brief AT24Cxx Record Layout
+ */
+#define AT24Cxx_LAYOUT_NONE         0xFFFFFFFFUL    /* record not placed */
+
+typedef struct
+{
+    uint32_t size;                  /* record size (byte) */
+    uint32_t freq;                  /* relative update frequency (saves per unit time) */
+    uint32_t addr;                  /* start address   (output of AT24Cxx_Layout_Plan) */
+    uint16_t cycles;                /* write cycles per save (output) */
+} AT24Cxx_RECORD_t;
+
+/**
+ * @brief AT24Cxx Multi-lane Software I2C Port (gang programming)
+ * Lane n uses bit n of every mask. Lines are open-drain, a 1 releases the line.
+ * The same bitstream is clocked on all lanes, acknowledges are read per lane.
+ */
+typedef struct
+{
+    void (*holdtime)(uint8_t mult);
+    void (*set_scl)(uint32_t mask);         /* SCL level per lane */
+    void (*set_sda)(uint32_t mask);         /* SDA level per lane */
+    uint32_t (*get_sda)(void);              /* SDA pin level per lane */
+    uint32_t lanes;                         /* connected lanes */
+} AT24Cxx_GANG_t;
+
+/**
+ * @brief AT24Cxx Persistent Variable
+ */
+#define AT24Cxx_VAR_LOADED          0x01            /* RAM image holds the EEPROM content */
+
+typedef struct
+{
+    uint32_t addr;                  /* EEPROM address */
+    uint16_t size;                  /* variable size (byte) */
+    uint8_t  state;                 /* AT24Cxx_VAR_LOADED */
+    uint32_t dirty;                 /* bit n : n-th page of the variable changed (bit 31 : page 31 and above) */
+    void    *ram;                   /* RAM image */
+    struct AT24Cxx_BOOT *boot;      /* boot region with a packed copy (set by AT24Cxx_Boot_Load) */
+} AT24Cxx_VAR_t;
+
+#define AT24Cxx_VAR_INIT(addr, var) { (addr), sizeof(var), 0, 0, &(var), NULL }
+
+/**
+ * @brief AT24Cxx Versioned Record (persistent variable behind a layout header)
+ * EEPROM : version, ~version, stored size (2 byte, LE), then the variable.
+ * migrate[v] converts a version v image of size byte in place and returns the
+ * version v + 1 size (0 --- failed). Every version must fit the current size,
+ * and the EEPROM slot must hold the header and the current size.
+ */
+#define AT24Cxx_SCHEMA_HEADSIZE     4
+
+typedef uint16_t (*AT24Cxx_MIGRATE_t)(void *data, uint16_t size);
+
+typedef struct
+{
+    AT24Cxx_VAR_t var;              /* variable, var.addr behind the header */
+    uint8_t version;                /* current layout version (0 - 254) */
+    uint8_t stale;                  /* EEPROM holds an older or no layout */
+    const AT24Cxx_MIGRATE_t *migrate;   /* migrate[0 .. version - 1] */
+} AT24Cxx_SCHEMA_t;
+
+#define AT24Cxx_SCHEMA_INIT(addr, var, version, migrate) \
+    { AT24Cxx_VAR_INIT((addr) + AT24Cxx_SCHEMA_HEADSIZE, var), (version), 0, (migrate) }
+
+/**
+ * @brief AT24Cxx Boot Region (packed copy of boot-critical variables)
+ */
+typedef struct AT24Cxx_BOOT
+{
+    uint32_t addr;                  /* region address (page aligned), 8 + sum of sizes byte */
+    AT24Cxx_VAR_t **var;            /* boot-critical variables, canonical copies at var->addr */
+    uint16_t num;                   /* number of variables */
+    uint8_t *image;                 /* region image (arena) */
+} AT24Cxx_BOOT_t;
+
+#define AT24Cxx_BOOT_INIT(addr, list) { (addr), (list), sizeof(list) / sizeof((list)[0]), NULL }
+
+/**
+ * @brief AT24Cxx Shadow (double-buffered RAM copy of an EEPROM range)
+ */
+typedef struct
+{
+    volatile uint32_t seq;          /* publish count, copy (seq & 1) is the published one */
+    at24cxx_t *dev;                 /* device structure pointer */
+    uint32_t addr;                  /* EEPROM address */
+    uint32_t size;                  /* range size (byte) */
+    volatile uint8_t *ram;          /* two RAM copies of size bytes (arena) */
+} AT24Cxx_SHADOW_t;
+
+/**
+ * @brief AT24Cxx Asynchronous Operation
+ */
+typedef enum
+{
+    AT24Cxx_OP_READ = 0x00,
+    AT24Cxx_OP_WRITE = 0x01,
+    AT24Cxx_OP_ERASE = 0x02,
+    AT24Cxx_OP_VERIFY = 0x03
+} AT24Cxx_OPTYPE;
+
+typedef enum
+{
+    AT24Cxx_OP_IDLE = 0x00,         /* never started */
+    AT24Cxx_OP_BUSY = 0x01,         /* next transfer pending, call AT24Cxx_Async_Poll */
+    AT24Cxx_OP_WAIT = 0x02,         /* self-timed write cycle in progress */
+    AT24Cxx_OP_DONE = 0x03,         /* finished */
+    AT24Cxx_OP_ERROR = 0x04,        /* finished with bus error */
+    AT24Cxx_OP_CANCEL = 0x05,       /* stopped by AT24Cxx_Async_Cancel, addr and remain tell the progress */
+    AT24Cxx_OP_MISMATCH = 0x06,     /* verify found a difference at addr */
+    AT24Cxx_OP_TIMEOUT = 0x07       /* write cycle exceeded the device timeout */
+} AT24Cxx_OPSTATE;
+
+typedef struct AT24Cxx_OP
+{
+    at24cxx_t *dev;
+    uint8_t type;                   /* AT24Cxx_OPTYPE */
+    volatile uint8_t state;         /* AT24Cxx_OPSTATE */
+    volatile uint8_t cancel;        /* cancel requested */
+    uint8_t fdata;                  /* filling data of erase and blank verify */
+    volatile uint32_t addr;         /* next address */
+    uint32_t remain;                /* remaining size */
+    uint32_t start;                 /* operation range [start, end) */
+    uint32_t end;
+    uint8_t *data;                  /* next data */
+    uint32_t stamp;                 /* tick of the last page program */
+    void (*done)(struct AT24Cxx_OP *op);    /* completion callback (may be NULL) */
+    void *arg;                      /* user argument */
+} AT24Cxx_OP_t;
+
 /**
  * @brief AT24Cxx Basic Function
  */
 void AT24Cxx_config(at24cxx_t *dev, AT24Cxx_CHIP type, uint8_t devaddr, uint8_t haraddr);  /* AT24Cxx Mount device */
+#if AT24Cxx_TIMEOUT_MS != 0
+void AT24Cxx_SetTimeout(at24cxx_t *dev, uint16_t ms);                                     /* Write cycle timeout */
+#endif
 uint8_t AT24Cxx_Write(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size);       /* AT24Cxx Write data */
 uint8_t AT24Cxx_Read(at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size);        /* AT24Cxx Read  data */
 uint8_t AT24Cxx_Erase(at24cxx_t *dev, uint32_t saddr, uint8_t fdata, uint32_t size);       /* AT24Cxx Erase data */
+uint8_t AT24Cxx_GetDevAddress(at24cxx_t *dev, uint32_t addr, uint8_t *addrsize);          /* AT24Cxx i2c address of word address */
+
+/**
+ * @brief AT24Cxx Arena Function
+ */
+void *AT24Cxx_Arena_Alloc(uint32_t size);                                                 /* Allocate at init, NULL when full */
+uint32_t AT24Cxx_Arena_Report(uint32_t *used, uint32_t *need);                            /* Static arena usage */
+
+/**
+ * @brief AT24Cxx Cache Function
+ */
+#if AT24Cxx_CACHE_SETS != 0
+uint8_t AT24Cxx_Cache_Init(at24cxx_t *dev);                                               /* Page cache from the arena */
+void AT24Cxx_Cache_Invalidate(at24cxx_t *dev);                                            /* Drop all lines */
+void AT24Cxx_Cache_Stats(at24cxx_t *dev, uint32_t *hits, uint32_t *misses);               /* Hit and miss pages */
+#endif
+
+/**
+ * @brief AT24Cxx Lazy Write Cycle Function
+ */
+#if AT24Cxx_LAZY_WCYCLE != 0
+uint8_t AT24Cxx_Lazy_Init(at24cxx_t *dev);                                                /* Pending page from the arena */
+uint8_t AT24Cxx_Lazy_Sync(at24cxx_t *dev);                                                   /* Finish the write cycle */
+#endif
+
+/**
+ * @brief AT24Cxx Deferred Write Function
+ */
+#if AT24Cxx_DEFER_PAGES != 0
+uint8_t AT24Cxx_Defer_Init(at24cxx_t *dev);                                               /* Staging pages from the arena */
+uint8_t AT24Cxx_Defer_Idle(at24cxx_t *dev, uint16_t budget);                              /* Program full or expired pages */
+uint8_t AT24Cxx_Defer_Flush(at24cxx_t *dev);                                              /* Program all staged pages */
+uint8_t AT24Cxx_Txn_Journal(at24cxx_t *dev, uint32_t addr, uint32_t size);                /* Atomic commits (size 0 : off) */
+uint8_t AT24Cxx_Txn_Recover(at24cxx_t *dev);                                              /* Replay sealed journal at startup */
+uint8_t AT24Cxx_Txn_Begin(at24cxx_t *dev);                                                /* Collect writes */
+uint8_t AT24Cxx_Txn_Commit(at24cxx_t *dev);                                               /* Program each page once */
+void AT24Cxx_Txn_Abort(at24cxx_t *dev);                                                   /* Drop collected writes */
+#endif
 
 /**
  * @brief AT24Cxx Application Function
  */
-uint8_t AT24Cxx_Readback_Write(at24cxx_t *dev, uint16_t addr, uint8_t *data, uint16_t size);
+uint8_t AT24Cxx_Readback_Write(at24cxx_t *dev, uint32_t addr, uint8_t *data, uint32_t size);
+
+/**
+ * @brief AT24Cxx Layout Function
+ */
+uint8_t AT24Cxx_Layout_Plan(at24cxx_t *dev, AT24Cxx_RECORD_t *rec, uint16_t num, uint32_t saddr, uint32_t *eaddr);
+uint32_t AT24Cxx_Layout_Cost(at24cxx_t *dev, AT24Cxx_RECORD_t *rec, uint16_t num);
+
+/**
+ * @brief AT24Cxx Gang Function
+ */
+uint32_t AT24Cxx_Gang_Write(AT24Cxx_GANG_t *gang, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size);
+uint32_t AT24Cxx_Gang_Verify(AT24Cxx_GANG_t *gang, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size);
+
+/**
+ * @brief AT24Cxx Persistent Variable Function
+ */
+const void *AT24Cxx_Var_Get(at24cxx_t *dev, AT24Cxx_VAR_t *var);                          /* Lazy load, NULL on error */
+uint8_t AT24Cxx_Var_Set(at24cxx_t *dev, AT24Cxx_VAR_t *var, const void *val);             /* Update RAM image */
+uint8_t AT24Cxx_Var_Commit(at24cxx_t *dev, AT24Cxx_VAR_t *var);                           /* Flush changed pages */
+
+/**
+ * @brief AT24Cxx Versioned Record Function
+ */
+const void *AT24Cxx_Schema_Get(at24cxx_t *dev, AT24Cxx_SCHEMA_t *rec);                    /* Load, migrate in RAM, NULL on error */
+uint8_t AT24Cxx_Schema_Set(at24cxx_t *dev, AT24Cxx_SCHEMA_t *rec, const void *val);       /* Update RAM image */
+uint8_t AT24Cxx_Schema_Commit(at24cxx_t *dev, AT24Cxx_SCHEMA_t *rec);                     /* Flush, rewrite migrated layout */
+
+/**
+ * @brief AT24Cxx Boot Region Function
+ */
+uint8_t AT24Cxx_Boot_Load(at24cxx_t *dev, AT24Cxx_BOOT_t *boot);                          /* One read, fallback to variables */
+uint8_t AT24Cxx_Boot_Commit(at24cxx_t *dev, AT24Cxx_BOOT_t *boot);                        /* Commit variables and region */
+
+/**
+ * @brief AT24Cxx Shadow Function
+ */
+uint8_t AT24Cxx_Shadow_Init(AT24Cxx_SHADOW_t *sh, at24cxx_t *dev, uint32_t addr, uint32_t size);   /* Allocate and load */
+uint8_t AT24Cxx_Shadow_Read(AT24Cxx_SHADOW_t *sh, uint32_t offset, void *data, uint32_t size);     /* Wait-free, ISR safe */
+uint8_t AT24Cxx_Shadow_Write(AT24Cxx_SHADOW_t *sh, uint32_t offset, const void *data, uint32_t size); /* Single writer task */
+
+/**
+ * @brief AT24Cxx Asynchronous Function
+ */
+uint8_t AT24Cxx_Async_Read(AT24Cxx_OP_t *op, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size);
+uint8_t AT24Cxx_Async_Write(AT24Cxx_OP_t *op, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint32_t size);
+uint8_t AT24Cxx_Async_Erase(AT24Cxx_OP_t *op, at24cxx_t *dev, uint32_t saddr, uint8_t fdata, uint32_t size);
+uint8_t AT24Cxx_Async_Verify(AT24Cxx_OP_t *op, at24cxx_t *dev, uint32_t saddr, uint8_t *data, uint8_t fdata, uint32_t size);
+AT24Cxx_OPSTATE AT24Cxx_Async_Poll(AT24Cxx_OP_t *op);                                     /* Advance one step */
+AT24Cxx_OPSTATE AT24Cxx_Async_Run(AT24Cxx_OP_t *op, uint16_t pages, uint16_t polls);     /* Advance within a budget */
+void AT24Cxx_Async_Cancel(AT24Cxx_OP_t *op);                                              /* Stop at the next page */
+uint8_t AT24Cxx_Async_Ready(AT24Cxx_OP_t *op, uint32_t addr, uint32_t size);              /* Preloaded range in RAM */
+uint8_t AT24Cxx_Async_Wait(AT24Cxx_OP_t *op, uint32_t addr, uint32_t size);               /* Read until range in RAM */
+void AT24Cxx_Async_Resume(AT24Cxx_OP_t *op);                                              /* Write cycle done */
+
+/**
+ * @brief AT24Cxx Compile-time Record Map
+ *
+ * A record map is a list macro of REC (typed record) and GAP (reserved bytes) entries.
+ * Offsets are computed by the compiler, the map is checked against the chip capacity
+ * and every REC flagged AT24Cxx_NOCROSS is checked to fit in a single page, so its
+ * store costs exactly one page program. A violated check fails the build.
+ *
+ *   #define PARAM_MAP(REC, GAP, map) \
+ *       REC(map, cfg,     cfg_t,    AT24Cxx_NOCROSS) \
+ *       GAP(map, rsv0,    4) \
+ *       REC(map, counter, uint32_t, AT24Cxx_NOCROSS)
+ *
+ *   AT24Cxx_RECORD_MAP(param, AT24C02, 0x0000, PARAM_MAP)
+ *
+ * generates param_cfg_load(dev, cfg_t *), param_cfg_store(dev, const cfg_t *),
+ * param_counter_load(...), param_counter_store(...) and AT24Cxx_MAP_ADDR(param, cfg).
+ * The record type must be a single type name (typedef arrays before use).
+ */
+#define AT24Cxx_CROSS               0               /* record may straddle pages */
+#define AT24Cxx_NOCROSS             1               /* record must fit in one page */
+
+#define AT24Cxx_STATIC_ASSERT(expr, name) \
+    typedef char AT24Cxx_assert_##name[(expr) ? 1 : -1]
+
+#define AT24Cxx_MAP_ADDR(map, name) \
+    ((uint32_t)(map##_BASE + offsetof(map##_map_t, name)))
+
+#define AT24Cxx_MAP_MEMBER(map, name, type, flag)   uint8_t name[sizeof(type)];
+#define AT24Cxx_MAP_GAP(map, name, size)            uint8_t name[size];
+#define AT24Cxx_MAP_SKIP(map, name, size)
+
+#define AT24Cxx_MAP_CHECK(map, name, type, flag) \
+    AT24Cxx_STATIC_ASSERT(!(flag) || \
+        AT24Cxx_MAP_ADDR(map, name) / AT24Cxx_PAGESIZE(map##_CHIP) == \
+        (AT24Cxx_MAP_ADDR(map, name) + sizeof(type) - 1) / AT24Cxx_PAGESIZE(map##_CHIP), \
+        map##_##name##_crosses_page);
+
+#define AT24Cxx_MAP_ACCESS(map, name, type, flag) \
+    static inline uint8_t map##_##name##_load(at24cxx_t *dev, type *val) \
+    { \
+        return AT24Cxx_Read(dev, AT24Cxx_MAP_ADDR(map, name), (uint8_t *)val, sizeof(type)); \
+    } \
+    static inline uint8_t map##_##name##_store(at24cxx_t *dev, const type *val) \
+    { \
+        return AT24Cxx_Write(dev, AT24Cxx_MAP_ADDR(map, name), (uint8_t *)val, sizeof(type)); \
+    }
+
+#define AT24Cxx_RECORD_MAP(map, chip, base, LIST) \
+    enum { map##_CHIP = (chip), map##_BASE = (base) }; \
+    typedef struct { LIST(AT24Cxx_MAP_MEMBER, AT24Cxx_MAP_GAP, map) } map##_map_t; \
+    AT24Cxx_STATIC_ASSERT((base) + sizeof(map##_map_t) <= AT24Cxx_CAPACITY(chip), map##_exceeds_capacity); \
+    LIST(AT24Cxx_MAP_CHECK, AT24Cxx_MAP_SKIP, map) \
+    LIST(AT24Cxx_MAP_ACCESS, AT24Cxx_MAP_SKIP, map)
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_gpiod.c
+ * @brief   Linux libgpiod (v1) software i2c port source file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * Both lines are requested together as open-drain outputs in one bulk request.
+ * - Every level change is one bulk set of both lines from a value cache,
+ *   writes that do not change a level are dropped.
+ * - Releasing SDA for reading drives it high (open-drain releases the line)
+ *   instead of switching the direction, get_sda reads the pin level, so the
+ *   direction is never reconfigured on the bit path.
+**/
+
+#define _DEFAULT_SOURCE
+#include "AT24Cxx_gpiod.h"
+#include <gpiod.h>
+#include <unistd.h>
+
+#define GPIOD_SCL           0
+#define GPIOD_SDA           1
+
+/* Line state */
+static struct gpiod_chip *AT24Cxx_Gpiod_Chip = NULL;
+static struct gpiod_line_bulk AT24Cxx_Gpiod_Lines;
+static int AT24Cxx_Gpiod_Value[2] = { 1, 1 };
+
+/**
+ * @brief  gpiod set one line level
+ * @param  {uint8_t} idx   : GPIOD_SCL or GPIOD_SDA
+ * @param  {uint8_t} level : line level
+ * @return none
+ * @note   One bulk request for both lines, nothing when the level is unchanged
+ */
+static void AT24Cxx_Gpiod_Set(uint8_t idx, uint8_t level)
+{
+    if (AT24Cxx_Gpiod_Value[idx] == (level ? 1 : 0)) return;
+
+    AT24Cxx_Gpiod_Value[idx] = level ? 1 : 0;
+    gpiod_line_set_value_bulk(&AT24Cxx_Gpiod_Lines, AT24Cxx_Gpiod_Value);
+}
+static void AT24Cxx_Gpiod_SetSCL(uint8_t level)
+{
+    AT24Cxx_Gpiod_Set(GPIOD_SCL, level);
+}
+static void AT24Cxx_Gpiod_SetSDA(uint8_t level)
+{
+    AT24Cxx_Gpiod_Set(GPIOD_SDA, level);
+}
+/**
+ * @brief  gpiod read SDA level
+ * @return {uint8_t} : SDA pin level
+ * @note   none
+ */
+static uint8_t AT24Cxx_Gpiod_GetSDA(void)
+{
+    return gpiod_line_get_value(gpiod_line_bulk_get_line(&AT24Cxx_Gpiod_Lines, GPIOD_SDA)) > 0;
+}
+/**
+ * @brief  gpiod SDA direction
+ * @param  {IO_MODE} mode : line mode
+ * @return none
+ * @note   Open-drain output stays output, input mode only releases the line
+ */
+static void AT24Cxx_Gpiod_ModeSDA(IO_MODE mode)
+{
+    if ((int)mode == AT24Cxx_GPIOD_MODE_IN) AT24Cxx_Gpiod_Set(GPIOD_SDA, 1);
+}
+static void AT24Cxx_Gpiod_ModeSCL(IO_MODE mode)
+{
+    if ((int)mode == AT24Cxx_GPIOD_MODE_IN) AT24Cxx_Gpiod_Set(GPIOD_SCL, 1);
+}
+/**
+ * @brief  gpiod bus hold time
+ * @param  {uint8_t} mult : number of hold time units
+ * @return none
+ * @note   none
+ */
+static void AT24Cxx_Gpiod_Hold(uint8_t mult)
+{
+#if AT24Cxx_GPIOD_HOLD_US > 0
+    usleep((useconds_t)mult * AT24Cxx_GPIOD_HOLD_US);
+#else
+    (void)mult;
+#endif
+}
+/**
+ * @brief  gpiod open software i2c port
+ * @param  {const char} *chip : gpio chip name, path or number (e.g. "gpiochip0")
+ * @param  {unsigned int} scl : SCL line offset
+ * @param  {unsigned int} sda : SDA line offset
+ * @param  {sw_i2c_t} *bus    : software i2c bus to fill
+ * @return {int}              : 0 --- success
+ *                              -1 --- error
+ * @note   Only one port instance, sw_i2c_t callbacks carry no context
+ */
+int AT24Cxx_Gpiod_Open(const char *chip, unsigned int scl, unsigned int sda, sw_i2c_t *bus)
+{
+    unsigned int offsets[2];
+
+    offsets[GPIOD_SCL] = scl;
+    offsets[GPIOD_SDA] = sda;
+
+    AT24Cxx_Gpiod_Chip = gpiod_chip_open_lookup(chip);
+    if (AT24Cxx_Gpiod_Chip == NULL) return -1;
+
+    /* Both lines in one open-drain output request, released (high) */
+    AT24Cxx_Gpiod_Value[GPIOD_SCL] = 1;
+    AT24Cxx_Gpiod_Value[GPIOD_SDA] = 1;
+    if (gpiod_chip_get_lines(AT24Cxx_Gpiod_Chip, offsets, 2, &AT24Cxx_Gpiod_Lines) < 0 || \
+        gpiod_line_request_bulk_output_flags(&AT24Cxx_Gpiod_Lines, "AT24Cxx", GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN, AT24Cxx_Gpiod_Value) < 0)
+    {
+        gpiod_chip_close(AT24Cxx_Gpiod_Chip);
+        AT24Cxx_Gpiod_Chip = NULL;
+        return -1;
+    }
+
+    bus->holdtime = AT24Cxx_Gpiod_Hold;
+    bus->sda_mode = AT24Cxx_Gpiod_ModeSDA;
+    bus->scl_mode = AT24Cxx_Gpiod_ModeSCL;
+    bus->set_scl = AT24Cxx_Gpiod_SetSCL;
+    bus->set_sda = AT24Cxx_Gpiod_SetSDA;
+    bus->get_sda = AT24Cxx_Gpiod_GetSDA;
+
+    return 0;
+}
+/**
+ * @brief  gpiod close software i2c port
+ * @return none
+ * @note   none
+ */
+void AT24Cxx_Gpiod_Close(void)
+{
+    if (AT24Cxx_Gpiod_Chip == NULL) return;
+
+    gpiod_line_release_bulk(&AT24Cxx_Gpiod_Lines);
+    gpiod_chip_close(AT24Cxx_Gpiod_Chip);
+    AT24Cxx_Gpiod_Chip = NULL;
+}
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_gpiod.h
+ * @brief   Linux libgpiod software i2c port header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+**/
+#ifndef __AT24CXX_GPIOD_H
+#define __AT24CXX_GPIOD_H
+#include "AT24Cxx.h"
+
+#if AT24Cxx_I2C_MODE != 0
+#error "AT24Cxx_gpiod is a software i2c port, set AT24Cxx_I2C_MODE to 0"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief IO_MODE value meaning input (SDA released for reading)
+ */
+#ifndef AT24Cxx_GPIOD_MODE_IN
+#define AT24Cxx_GPIOD_MODE_IN       0
+#endif
+
+/**
+ * @brief Hold time of one holdtime() unit (us)
+ * 0 : no delay, the gpiod call latency already exceeds the i2c timing
+ */
+#ifndef AT24Cxx_GPIOD_HOLD_US
+#define AT24Cxx_GPIOD_HOLD_US       0
+#endif
+
+int  AT24Cxx_Gpiod_Open(const char *chip, unsigned int scl, unsigned int sda, sw_i2c_t *bus);   /* 0 : success */
+void AT24Cxx_Gpiod_Close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,387 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_i2cdev.c
+ * @brief   Linux i2c-dev hardware i2c port source file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *                                              1. Add batched reads
+**/
+
+#define _DEFAULT_SOURCE
+#include "AT24Cxx_i2cdev.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+/* Adapter of the calling thread */
+static __thread int AT24Cxx_I2cdev_Fd = -1;
+
+/**
+ * @brief  i2c-dev transfer messages
+ * @param  {struct i2c_msg} *msgs : message list
+ * @param  {uint32_t} num         : number of messages
+ * @return {uint8_t}              : 0 --- success
+ *                                  1 --- error
+ * @note   none
+ */
+static uint8_t AT24Cxx_I2cdev_Transfer(struct i2c_msg *msgs, uint32_t num)
+{
+    struct i2c_rdwr_ioctl_data rdwr;
+
+    rdwr.msgs = msgs;
+    rdwr.nmsgs = num;
+
+    return (ioctl(AT24Cxx_I2cdev_Fd, I2C_RDWR, &rdwr) == (int)num) ? 0 : 1;
+}
+/**
+ * @brief  i2c-dev send data
+ * @param  {uint16_t} devaddr : device address (8 bit, R/W bit ignored)
+ * @param  {uint8_t} *pdata   : send data pointer
+ * @param  {uint32_t} size    : send data size (0 : address only, acknowledge polling)
+ * @return {uint8_t}          : 0 --- success
+ *                              1 --- error
+ * @note   none
+ */
+static uint8_t AT24Cxx_I2cdev_Send(uint16_t devaddr, uint8_t *pdata, uint32_t size)
+{
+    struct i2c_msg msg;
+
+    if (size > AT24Cxx_I2CDEV_MAX_MSG_LEN) return 1;
+
+    msg.addr = devaddr >> 1;
+    msg.flags = 0;
+    msg.len = (uint16_t)size;
+    msg.buf = pdata;
+
+    return AT24Cxx_I2cdev_Transfer(&msg, 1);
+}
+/**
+ * @brief  i2c-dev receive data
+ * @param  {uint16_t} devaddr : device address (8 bit, R/W bit ignored)
+ * @param  {uint8_t} *pdata   : receive data pointer
+ * @param  {uint32_t} size    : receive data size
+ * @return {uint8_t}          : 0 --- success
+ *                              1 --- error
+ * @note   none
+ */
+static uint8_t AT24Cxx_I2cdev_Recv(uint16_t devaddr, uint8_t *pdata, uint32_t size)
+{
+    struct i2c_msg msg;
+
+    if (size > AT24Cxx_I2CDEV_MAX_MSG_LEN) return 1;
+
+    msg.addr = devaddr >> 1;
+    msg.flags = I2C_M_RD;
+    msg.len = (uint16_t)size;
+    msg.buf = pdata;
+
+    return AT24Cxx_I2cdev_Transfer(&msg, 1);
+}
+/**
+ * @brief  i2c-dev write memory
+ * @param  {uint16_t} devaddr    : device address (8 bit, R/W bit ignored)
+ * @param  {uint16_t} memaddr    : word address
+ * @param  {uint8_t} memaddrsize : word address size (1 or 2)
+ * @param  {uint8_t} *pdata      : write data pointer
+ * @param  {uint32_t} size       : write data size (one page at most)
+ * @return {uint8_t}             : 0 --- success
+ *                                 1 --- error (or write cycle timeout)
+ * @note   Returns after the self-timed write cycle, detected by acknowledge
+ *         polling, so the calling thread sleeps instead of the bus being held.
+ */
+static uint8_t AT24Cxx_I2cdev_Wmem(uint16_t devaddr, uint16_t memaddr, uint8_t memaddrsize, uint8_t *pdata, uint32_t size)
+{
+    uint8_t buf[2 + 256];
+    uint32_t wait = 0;
+
+    if (size > sizeof(buf) - 2) return 1;
+
+    /* Word address followed by data */
+    if (memaddrsize == 2) buf[0] = (uint8_t)(memaddr >> 8);
+    buf[memaddrsize - 1] = (uint8_t)memaddr;
+    memcpy(buf + memaddrsize, pdata, size);
+
+    if (AT24Cxx_I2cdev_Send(devaddr, buf, memaddrsize + size)) return 1;
+
+    /* Self-timed Write cycle */
+    do
+    {
+        usleep(AT24Cxx_I2CDEV_POLL_INTERVAL);
+        wait += AT24Cxx_I2CDEV_POLL_INTERVAL;
+        if (AT24Cxx_I2cdev_Send(devaddr, NULL, 0) == 0) return 0;
+    } while (wait < AT24Cxx_I2CDEV_WCYCLE_TIMEOUT);
+
+    return 1;
+}
+/**
+ * @brief  i2c-dev read memory
+ * @param  {uint16_t} devaddr    : device address (8 bit, R/W bit ignored)
+ * @param  {uint16_t} memaddr    : word address
+ * @param  {uint8_t} memaddrsize : word address size (1 or 2)
+ * @param  {uint8_t} *pdata      : read data pointer
+ * @param  {uint32_t} size       : read data size
+ * @return {uint8_t}             : 0 --- success
+ *                                 1 --- error
+ * @note   Reads longer than one i2c-dev message are split. The driver never
+ *         passes a read across a block of the device address, so the word
+ *         address only rolls over like in the chip.
+ */
+static uint8_t AT24Cxx_I2cdev_Rmem(uint16_t devaddr, uint16_t memaddr, uint8_t memaddrsize, uint8_t *pdata, uint32_t size)
+{
+    struct i2c_msg msgs[2];
+    uint8_t buf[2];
+    uint32_t addr = memaddr;
+    uint32_t len;
+
+    while (size > 0)
+    {
+        len = (size < AT24Cxx_I2CDEV_MAX_MSG_LEN) ? size : AT24Cxx_I2CDEV_MAX_MSG_LEN;
+
+        /* Word address rolls over */
+        addr &= (memaddrsize == 2) ? 0xFFFF : 0xFF;
+
+        /* Word address */
+        if (memaddrsize == 2)
+        {
+            buf[0] = (uint8_t)(addr >> 8);
+            buf[1] = (uint8_t)addr;
+        }
+        else
+        {
+            buf[0] = (uint8_t)addr;
+        }
+
+        msgs[0].addr = devaddr >> 1;
+        msgs[0].flags = 0;
+        msgs[0].len = memaddrsize;
+        msgs[0].buf = buf;
+        msgs[1].addr = devaddr >> 1;
+        msgs[1].flags = I2C_M_RD;
+        msgs[1].len = (uint16_t)len;
+        msgs[1].buf = pdata;
+
+        if (AT24Cxx_I2cdev_Transfer(msgs, 2)) return 1;
+
+        addr += len;
+        pdata += len;
+        size -= len;
+    }
+
+    return 0;
+}
+/**
+ * @brief Linux i2c-dev hardware i2c port
+ */
+hw_i2c_t AT24Cxx_I2cdev_Bus =
+{
+    AT24Cxx_I2cdev_Send,
+    AT24Cxx_I2cdev_Recv,
+    AT24Cxx_I2cdev_Wmem,
+    AT24Cxx_I2cdev_Rmem
+};
+/**
+ * @brief  i2c-dev open adapter
+ * @param  {const char} *path : adapter path (e.g. "/dev/i2c-1")
+ * @return {int}              : adapter file descriptor, -1 --- error
+ * @note   none
+ */
+int AT24Cxx_I2cdev_Open(const char *path)
+{
+    return open(path, O_RDWR);
+}
+/**
+ * @brief  i2c-dev select adapter of the calling thread
+ * @param  {int} fd : adapter file descriptor
+ * @return none
+ * @note   Call before any driver function in each thread
+ */
+void AT24Cxx_I2cdev_Bind(int fd)
+{
+    AT24Cxx_I2cdev_Fd = fd;
+}
+/**
+ * @brief  i2c-dev close adapter
+ * @param  {int} fd : adapter file descriptor
+ * @return none
+ * @note   none
+ */
+void AT24Cxx_I2cdev_Close(int fd)
+{
+    if (AT24Cxx_I2cdev_Fd == fd) AT24Cxx_I2cdev_Fd = -1;
+
+    close(fd);
+}
+/**
+ * @brief  i2c-dev check driver layers of a device
+ * @param  {at24cxx_t} *dev : device structure pointer
+ * @return {uint8_t}        : 0 --- raw transfers see the memory
+ *                            1 --- reads must go through AT24Cxx_Read
+ * @note   A raw transfer misses the page cache, the staged writes and the
+ *         wait for a pending write cycle.
+ */
+static uint8_t AT24Cxx_I2cdev_Layered(at24cxx_t *dev)
+{
+#if AT24Cxx_CACHE_SETS != 0
+    if (dev->cache != NULL) return 1;
+#endif
+#if AT24Cxx_DEFER_PAGES != 0
+    if (dev->defer != NULL) return 1;
+#endif
+#if AT24Cxx_LAZY_WCYCLE != 0
+    if (dev->pend != NULL) return 1;
+#endif
+    (void)dev;
+
+    return 0;
+}
+/**
+ * @brief  i2c-dev length of the next read message of a request
+ * @param  {at24cxx_t} *dev   : device structure pointer
+ * @param  {uint32_t} addr    : word address
+ * @param  {uint32_t} remain  : remaining size
+ * @param  {uint8_t} *devaddr : device address (8 bit, block bits included)
+ * @param  {uint8_t} *asize   : word address size (1 or 2)
+ * @return {uint32_t}         : message length
+ * @note   Split like AT24Cxx_Fetch, a message never carries into the block bits
+ *         of the device address (A8 - A10, A16 - A17)
+ */
+static uint32_t AT24Cxx_I2cdev_Span(at24cxx_t *dev, uint32_t addr, uint32_t remain, uint8_t *devaddr, uint8_t *asize)
+{
+    uint32_t span, len;
+
+    *devaddr = AT24Cxx_GetDevAddress(dev, addr, asize);
+    span = 1UL << (8 * *asize);
+    len = span - (addr & (span - 1));
+    if (len > remain) len = remain;
+    if (len > AT24Cxx_I2CDEV_MAX_MSG_LEN) len = AT24Cxx_I2CDEV_MAX_MSG_LEN;
+
+    return len;
+}
+/**
+ * @brief  i2c-dev issue one batch of read requests
+ * @param  {AT24Cxx_I2CDEV_READ_t} *req : read request list
+ * @param  {uint32_t} num               : number of requests
+ * @param  {struct i2c_msg} *msgs       : prepared messages
+ * @param  {uint32_t} nmsgs             : number of messages
+ * @return {uint8_t}                    : 0 --- success
+ *                                        1 --- error
+ * @note   A failed batch is retried request by request to find the failed ones
+ */
+static uint8_t AT24Cxx_I2cdev_Flush(AT24Cxx_I2CDEV_READ_t *req, uint32_t num, struct i2c_msg *msgs, uint32_t nmsgs)
+{
+    uint32_t i;
+    uint8_t rsp = 0;
+
+    if (nmsgs == 0 || AT24Cxx_I2cdev_Transfer(msgs, nmsgs) == 0) return 0;
+
+    for (i = 0; i < num; i++)
+    {
+        req[i].rsp = AT24Cxx_Read(req[i].dev, req[i].addr, req[i].data, req[i].size);
+        rsp |= req[i].rsp;
+    }
+
+    return rsp;
+}
+/**
+ * @brief  i2c-dev batched read
+ * @param  {AT24Cxx_I2CDEV_READ_t} *req : read request list (devices on the bound adapter)
+ * @param  {uint32_t} num               : number of requests
+ * @return {uint8_t}                    : 0 --- success
+ *                                        1 --- error (see req[i].rsp)
+ * @note   Independent reads (any address, any device of the adapter) are packed
+ *         as word address write + data read message pairs into as few I2C_RDWR
+ *         calls as the per-call message limit allows, one pair per block of the
+ *         device address a request touches. A request larger than one
+ *         call can carry, or of a device with a page cache, staged writes or
+ *         lazy write cycle attached, falls back to AT24Cxx_Read.
+ */
+uint8_t AT24Cxx_I2cdev_ReadBatch(AT24Cxx_I2CDEV_READ_t *req, uint32_t num)
+{
+    struct i2c_msg msgs[AT24Cxx_I2CDEV_MAX_MSGS];
+    uint8_t abuf[AT24Cxx_I2CDEV_MAX_MSGS / 2][2];
+    uint32_t i, first = 0, nmsgs = 0;
+    uint32_t pairs, off, len, addr;
+    uint8_t devaddr, asize;
+    uint8_t rsp = 0;
+
+    for (i = 0; i < num; i++)
+    {
+        req[i].rsp = 0;
+        for (pairs = 0, off = 0; off < req[i].size; off += len, pairs++)
+        {
+            len = AT24Cxx_I2cdev_Span(req[i].dev, req[i].addr + off, req[i].size - off, &devaddr, &asize);
+        }
+
+        /* Too large for one call, or served by the driver layers */
+        if (pairs * 2 > AT24Cxx_I2CDEV_MAX_MSGS || AT24Cxx_I2cdev_Layered(req[i].dev))
+        {
+            rsp |= AT24Cxx_I2cdev_Flush(&req[first], i - first, msgs, nmsgs);
+            nmsgs = 0;
+
+            req[i].rsp = AT24Cxx_Read(req[i].dev, req[i].addr, req[i].data, req[i].size);
+            rsp |= req[i].rsp;
+            continue;
+        }
+
+        /* Issue the current batch when the request does not fit */
+        if (nmsgs + pairs * 2 > AT24Cxx_I2CDEV_MAX_MSGS)
+        {
+            rsp |= AT24Cxx_I2cdev_Flush(&req[first], i - first, msgs, nmsgs);
+            first = i;
+            nmsgs = 0;
+        }
+        if (nmsgs == 0) first = i;
+
+        for (off = 0; off < req[i].size; off += len)
+        {
+            /* Word address and device address (block bits included) */
+            addr = req[i].addr + off;
+            len = AT24Cxx_I2cdev_Span(req[i].dev, addr, req[i].size - off, &devaddr, &asize);
+            if (asize == 2)
+            {
+                abuf[nmsgs / 2][0] = (uint8_t)(addr >> 8);
+                abuf[nmsgs / 2][1] = (uint8_t)addr;
+            }
+            else
+            {
+                abuf[nmsgs / 2][0] = (uint8_t)addr;
+            }
+
+            msgs[nmsgs].addr = devaddr >> 1;
+            msgs[nmsgs].flags = 0;
+            msgs[nmsgs].len = asize;
+            msgs[nmsgs].buf = abuf[nmsgs / 2];
+            msgs[nmsgs + 1].addr = devaddr >> 1;
+            msgs[nmsgs + 1].flags = I2C_M_RD;
+            msgs[nmsgs + 1].len = (uint16_t)len;
+            msgs[nmsgs + 1].buf = req[i].data + off;
+            nmsgs += 2;
+        }
+    }
+
+    if (nmsgs != 0)
+    {
+        rsp |= AT24Cxx_I2cdev_Flush(&req[first], num - first, msgs, nmsgs);
+    }
+
+    return rsp;
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_i2cdev.h
+ * @brief   Linux i2c-dev hardware i2c port header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *                                              1. Add batched reads
+**/
+#ifndef __AT24CXX_I2CDEV_H
+#define __AT24CXX_I2CDEV_H
+#include "AT24Cxx.h"
+
+#if AT24Cxx_I2C_MODE == 0
+#error "AT24Cxx_i2cdev is a hardware i2c port, set AT24Cxx_I2C_MODE to 1"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Write cycle acknowledge polling timeout (us)
+ */
+#ifndef AT24Cxx_I2CDEV_WCYCLE_TIMEOUT
+#define AT24Cxx_I2CDEV_WCYCLE_TIMEOUT   20000
+#endif
+
+/**
+ * @brief Acknowledge polling interval (us)
+ */
+#ifndef AT24Cxx_I2CDEV_POLL_INTERVAL
+#define AT24Cxx_I2CDEV_POLL_INTERVAL    200
+#endif
+
+/**
+ * @brief Maximum length of one i2c-dev message (kernel limit)
+ */
+#define AT24Cxx_I2CDEV_MAX_MSG_LEN      8192
+
+/**
+ * @brief Maximum number of messages of one I2C_RDWR call (kernel limit)
+ */
+#define AT24Cxx_I2CDEV_MAX_MSGS         42
+
+/**
+ * @brief Batched read request
+ */
+typedef struct
+{
+    at24cxx_t *dev;                 /* device on the bound adapter */
+    uint32_t addr;                  /* start address */
+    uint8_t *data;                  /* read data pointer */
+    uint32_t size;                  /* read data size */
+    uint8_t rsp;                    /* 0 : success, 1 : error (output) */
+} AT24Cxx_I2CDEV_READ_t;
+
+/**
+ * @brief Linux i2c-dev hardware i2c port
+ * hw_i2c_t callbacks carry no context, the adapter is selected per thread
+ * with AT24Cxx_I2cdev_Bind, so one thread per adapter can share this port.
+ */
+extern hw_i2c_t AT24Cxx_I2cdev_Bus;
+
+int  AT24Cxx_I2cdev_Open(const char *path);        /* Open adapter, return fd or -1 */
+void AT24Cxx_I2cdev_Bind(int fd);                  /* Select adapter of the calling thread */
+void AT24Cxx_I2cdev_Close(int fd);                 /* Close adapter */
+uint8_t AT24Cxx_I2cdev_ReadBatch(AT24Cxx_I2CDEV_READ_t *req, uint32_t num);    /* Many reads, few ioctl */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,655 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_sim.c
+ * @brief   Simulated i2c bus (hardware port and software line model) and AT24Cxx devices source file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * Devices follow the datasheet behaviour the driver relies on: block bits in the
+ * device address, page roll-over of page programs, memory roll-over of sequential
+ * reads, no acknowledge during the self-timed write cycle. Time advances by the
+ * bus bit time of every transfer and by the write cycle wait model.
+ *
+ * The software port decodes the SCL and SDA levels set by the driver (START,
+ * STOP, nine clock frames) into the same devices, so the open-drain bit-bang
+ * path runs against the same memory, timing and power model.
+ *
+ * Power loss : a page program starts at the STOP condition, so a cut while the
+ * bytes are clocked leaves memory unchanged; a cut in the write cycle leaves the
+ * page partially programmed. After a cut every transfer fails until power on.
+**/
+
+#include "AT24Cxx_sim.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Tool Function */
+#define min(a, b)           (((a) < (b)) ? (a) : (b))       /* Take the minimum value */
+
+/* Fixed write cycle wait of the driver (ns) */
+#define SIM_WCYCLE_FIXED_NS         5000000ULL
+
+AT24Cxx_SIM_t AT24Cxx_Sim;
+
+/* Software line phases */
+#define SIM_LINE_IDLE               0               /* not addressed, wait for START */
+#define SIM_LINE_ADDR               1               /* device address byte */
+#define SIM_LINE_WORD               2               /* word address bytes */
+#define SIM_LINE_DATA               3               /* page program data */
+#define SIM_LINE_TX                 4               /* sequential read */
+
+/**
+ * @brief Software line state
+ */
+typedef struct
+{
+    uint8_t scl, sda;               /* levels driven by the master */
+    uint8_t out;                    /* SDA level driven by the device (0 : pulled low) */
+    uint8_t phase;                  /* SIM_LINE_xxx */
+    uint8_t next;                   /* phase after the acknowledge clock */
+    uint8_t bit;                    /* clocks of the frame (8 : acknowledge clock) */
+    uint8_t byte;                   /* shift register */
+    uint8_t nack;                   /* master did not acknowledge a read byte */
+    uint8_t devaddr;                /* device address of the transfer */
+    uint8_t words;                  /* word address bytes still expected */
+    uint16_t memaddr;               /* word address */
+    uint32_t addr;                  /* absolute address, read pointer */
+    uint32_t n;                     /* data bytes received */
+    AT24Cxx_SIM_DEV_t *sdev;        /* addressed device */
+    uint8_t buf[256];               /* page program data (largest page) */
+} AT24Cxx_SIM_LINE_t;
+
+static AT24Cxx_SIM_LINE_t AT24Cxx_SimLine;
+
+/**
+ * @brief  Get number of block bits in the device address
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : number of block bits
+ */
+static uint8_t AT24Cxx_Sim_BlockBits(AT24Cxx_CHIP type)
+{
+    switch (type)
+    {
+        case AT24C04: return 1;
+        case AT24C08: return 2;
+        case AT24C16: return 3;
+        case AT24CM01: return 1;
+        case AT24CM02: return 2;
+        default: return 0;
+    }
+}
+/**
+ * @brief  Advance time by a transfer of n bytes
+ * @param  {uint32_t} n : bytes on the bus (device address included)
+ * @return none
+ * @note   9 clocks per byte plus start and stop
+ */
+static void AT24Cxx_Sim_Clock(uint32_t n)
+{
+    AT24Cxx_Sim.now += ((uint64_t)n * 9 + 2) * 1000000000ULL / AT24Cxx_Sim.bus_hz;
+}
+/**
+ * @brief  Clock a transfer of n bytes through the power model
+ * @param  {uint32_t} n : bytes on the bus (device address included)
+ * @return {uint8_t}    : 0 --- powered
+ *                        1 --- power is lost (before or during the transfer)
+ */
+static uint8_t AT24Cxx_Sim_Transfer(uint32_t n)
+{
+    AT24Cxx_Sim_Clock(n);
+    AT24Cxx_Sim.bytes += n;
+    AT24Cxx_Sim.transfers++;
+
+    if (AT24Cxx_Sim.off) return 1;
+
+    if (AT24Cxx_Sim.cutbyte != 0)
+    {
+        if (n >= AT24Cxx_Sim.cutbyte)
+        {
+            AT24Cxx_Sim.cutbyte = 0;
+            AT24Cxx_Sim.off = 1;
+            return 1;
+        }
+        AT24Cxx_Sim.cutbyte -= n;
+    }
+
+    return 0;
+}
+/**
+ * @brief  Select device and absolute address of a transfer
+ * @param  {uint16_t} devaddr    : device address (8 bit)
+ * @param  {uint16_t} memaddr    : word address
+ * @param  {uint32_t} *addr      : absolute memory address
+ * @return {AT24Cxx_SIM_DEV_t *} : device, NULL --- no acknowledge
+ * @note   A device in its write cycle does not acknowledge
+ */
+static AT24Cxx_SIM_DEV_t *AT24Cxx_Sim_Select(uint16_t devaddr, uint16_t memaddr, uint32_t *addr)
+{
+    AT24Cxx_SIM_DEV_t *sdev;
+    uint8_t i, bbits, pins, block;
+
+    if (((devaddr >> 4) & 0x0F) != 0x0A) return NULL;
+
+    for (i = 0; i < AT24Cxx_Sim.ndev; i++)
+    {
+        sdev = &AT24Cxx_Sim.dev[i];
+        bbits = AT24Cxx_Sim_BlockBits(sdev->type);
+        pins = (uint8_t)((devaddr >> 1) & 0x07);
+        block = pins & ((1 << bbits) - 1);
+
+        /* Hardware pins not used as block bits must match */
+        if ((pins >> bbits) != (sdev->hardaddr >> bbits)) continue;
+
+        if (AT24Cxx_Sim.now < sdev->busy)
+        {
+            sdev->nacks++;
+            return NULL;
+        }
+
+        if (sdev->type >= AT24C32)
+        {
+            *addr = ((uint32_t)block << 16) | memaddr;
+        }
+        else
+        {
+            *addr = ((uint32_t)block << 8) | (memaddr & 0xFF);
+        }
+        *addr %= AT24Cxx_CAPACITY(sdev->type);
+
+        return sdev;
+    }
+
+    return NULL;
+}
+/**
+ * @brief  Simulated send (acknowledge polling when size is 0)
+ */
+static uint8_t AT24Cxx_Sim_Send(uint16_t devaddr, uint8_t *pdata, uint32_t size)
+{
+    uint32_t addr;
+
+    (void)pdata;
+    if (AT24Cxx_Sim_Transfer(1 + size)) return 1;
+
+    return (AT24Cxx_Sim_Select(devaddr, 0, &addr) != NULL) ? 0 : 1;
+}
+/**
+ * @brief  Simulated receive (current address read is not modelled)
+ */
+static uint8_t AT24Cxx_Sim_Recv(uint16_t devaddr, uint8_t *pdata, uint32_t size)
+{
+    (void)devaddr;
+    (void)pdata;
+    AT24Cxx_Sim_Transfer(1 + size);
+
+    return 1;
+}
+/**
+ * @brief  Program a page of a selected device
+ * @param  {AT24Cxx_SIM_DEV_t} *sdev : device
+ * @param  {uint32_t} addr           : absolute memory address
+ * @param  {uint8_t} *pdata          : data
+ * @param  {uint32_t} size           : data size
+ * @return none
+ * @note   Data rolls over within the page, the device is busy for the write cycle
+ */
+static void AT24Cxx_Sim_Program(AT24Cxx_SIM_DEV_t *sdev, uint32_t addr, uint8_t *pdata, uint32_t size)
+{
+    uint32_t base, pagesize, keep, i;
+    uint64_t poll;
+
+    /* Power lost in this write cycle, only the first bytes are programmed */
+    keep = size;
+    if (AT24Cxx_Sim.cutprog != 0 && --AT24Cxx_Sim.cutprog == 0)
+    {
+        keep = min(size, AT24Cxx_Sim.cutkeep);
+        AT24Cxx_Sim.off = 1;
+    }
+
+    pagesize = AT24Cxx_PAGESIZE(sdev->type);
+    base = addr - addr % pagesize;
+    for (i = 0; i < keep; i++)
+    {
+        sdev->mem[base + (addr - base + i) % pagesize] = pdata[i];
+    }
+
+    /* Endurance is exceeded by the first program beyond the rated cycles */
+    if (++sdev->wear[base / pagesize] > AT24Cxx_Sim.endurance && AT24Cxx_Sim.endurance != 0 && sdev->failpage == AT24Cxx_SIM_NOFAIL)
+    {
+        sdev->failpage = base / pagesize;
+        sdev->failtime = AT24Cxx_Sim.now;
+    }
+    sdev->programs++;
+    sdev->wbytes += size;
+
+    /* Self-timed Write cycle */
+    sdev->busy = AT24Cxx_Sim.now + AT24Cxx_Sim.twr_ns;
+    if (AT24Cxx_Sim.wait == AT24Cxx_SIM_WAIT_FIXED)
+    {
+        AT24Cxx_Sim.now += SIM_WCYCLE_FIXED_NS;
+    }
+    else if (AT24Cxx_Sim.wait == AT24Cxx_SIM_WAIT_ACKPOLL)
+    {
+        /* Acknowledge polls (one address byte each) until the device answers */
+        poll = (9 + 2) * 1000000000ULL / AT24Cxx_Sim.bus_hz;
+        AT24Cxx_Sim.now += (AT24Cxx_Sim.twr_ns + poll - 1) / poll * poll;
+    }
+}
+/**
+ * @brief  Simulated page program
+ */
+static uint8_t AT24Cxx_Sim_Wmem(uint16_t devaddr, uint16_t memaddr, uint8_t memaddrsize, uint8_t *pdata, uint32_t size)
+{
+    AT24Cxx_SIM_DEV_t *sdev;
+    uint32_t addr;
+
+    if (AT24Cxx_Sim_Transfer(1 + memaddrsize + size)) return 1;
+
+    sdev = AT24Cxx_Sim_Select(devaddr, memaddr, &addr);
+    if (sdev == NULL) return 1;
+
+    AT24Cxx_Sim_Program(sdev, addr, pdata, size);
+
+    return 0;
+}
+/**
+ * @brief  Simulated sequential read
+ * @note   Address rolls over at the end of the memory
+ */
+static uint8_t AT24Cxx_Sim_Rmem(uint16_t devaddr, uint16_t memaddr, uint8_t memaddrsize, uint8_t *pdata, uint32_t size)
+{
+    AT24Cxx_SIM_DEV_t *sdev;
+    uint32_t addr, cap, i;
+
+    if (AT24Cxx_Sim_Transfer(1 + memaddrsize + 1 + size)) return 1;
+
+    sdev = AT24Cxx_Sim_Select(devaddr, memaddr, &addr);
+    if (sdev == NULL) return 1;
+
+    cap = AT24Cxx_CAPACITY(sdev->type);
+    for (i = 0; i < size; i++)
+    {
+        pdata[i] = sdev->mem[(addr + i) % cap];
+    }
+
+    sdev->reads++;
+    sdev->rbytes += size;
+
+    return 0;
+}
+/**
+ * @brief Simulated hardware i2c port
+ */
+hw_i2c_t AT24Cxx_Sim_Bus =
+{
+    AT24Cxx_Sim_Send,
+    AT24Cxx_Sim_Recv,
+    AT24Cxx_Sim_Wmem,
+    AT24Cxx_Sim_Rmem
+};
+/**
+ * @brief  Software line byte clocked in by the device
+ * @param  {AT24Cxx_SIM_LINE_t} *l : line
+ * @return {uint8_t}               : 0 --- acknowledge
+ *                                   1 --- no acknowledge (not addressed, busy or power lost)
+ * @note   Sets the phase that follows the acknowledge clock
+ */
+static uint8_t AT24Cxx_Sim_LineRecv(AT24Cxx_SIM_LINE_t *l)
+{
+    uint32_t addr;
+
+    l->next = l->phase;
+
+    switch (l->phase)
+    {
+        case SIM_LINE_ADDR: {
+            l->devaddr = l->byte;
+            l->sdev = AT24Cxx_Sim_Select(l->devaddr & 0xFE, 0, &addr);
+            if (l->sdev == NULL) return 1;
+
+            if (l->devaddr & 0x01)
+            {
+                /* Read from the address pointer of the dummy write */
+                l->sdev->reads++;
+                l->addr %= AT24Cxx_CAPACITY(l->sdev->type);
+                l->nack = 0;
+                l->next = SIM_LINE_TX;
+            }
+            else
+            {
+                l->words = (l->sdev->type >= AT24C32) ? 2 : 1;
+                l->memaddr = 0;
+                l->next = SIM_LINE_WORD;
+            }
+            return 0;}
+        case SIM_LINE_WORD: {
+            l->memaddr = (uint16_t)((l->memaddr << 8) | l->byte);
+            if (--l->words == 0)
+            {
+                AT24Cxx_Sim_Select(l->devaddr & 0xFE, l->memaddr, &l->addr);
+                l->n = 0;
+                l->next = SIM_LINE_DATA;
+            }
+            return 0;}
+        case SIM_LINE_DATA: {
+            /* The driver never sends more than a page */
+            if (l->n < sizeof(l->buf)) l->buf[l->n++] = l->byte;
+            return 0;}
+        default: return 1;
+    }
+}
+/**
+ * @brief  Software line byte clocked on the bus (power model)
+ * @param  {AT24Cxx_SIM_LINE_t} *l : line
+ * @return {uint8_t}               : 0 --- powered
+ *                                   1 --- power is lost, the device drops the transfer
+ */
+static uint8_t AT24Cxx_Sim_LineByte(AT24Cxx_SIM_LINE_t *l)
+{
+    AT24Cxx_Sim.bytes++;
+
+    if (!AT24Cxx_Sim.off && AT24Cxx_Sim.cutbyte != 0 && --AT24Cxx_Sim.cutbyte == 0) AT24Cxx_Sim.off = 1;
+    if (!AT24Cxx_Sim.off) return 0;
+
+    l->phase = SIM_LINE_IDLE;
+    l->out = 1;
+
+    return 1;
+}
+/**
+ * @brief  Simulated software line, master sets SCL
+ * @note   A rising edge takes one bit time and samples SDA, the device changes
+ *         SDA after the falling edge
+ */
+static void AT24Cxx_Sim_SetScl(uint8_t level)
+{
+    AT24Cxx_SIM_LINE_t *l = &AT24Cxx_SimLine;
+
+    level = level ? 1 : 0;
+    if (level == l->scl) return;
+    l->scl = level;
+
+    if (level)
+    {
+        AT24Cxx_Sim.now += 1000000000ULL / AT24Cxx_Sim.bus_hz;
+
+        if (l->phase == SIM_LINE_IDLE) return;
+        if (l->bit < 8)
+        {
+            if (l->phase != SIM_LINE_TX) l->byte = (uint8_t)((l->byte << 1) | l->sda);
+        }
+        else if (l->phase == SIM_LINE_TX)
+        {
+            l->nack = l->sda;
+        }
+        l->bit++;
+        return;
+    }
+
+    if (l->phase == SIM_LINE_IDLE) return;
+
+    /* Next data bit of a read */
+    if (l->bit < 8)
+    {
+        if (l->phase == SIM_LINE_TX && l->bit != 0) l->out = (l->byte >> (7 - l->bit)) & 0x01;
+        return;
+    }
+
+    /* Byte complete, acknowledge clock follows */
+    if (l->bit == 8)
+    {
+        if (AT24Cxx_Sim_LineByte(l)) return;
+
+        if (l->phase == SIM_LINE_TX)
+        {
+            l->sdev->rbytes++;
+            l->out = 1;
+        }
+        else if (AT24Cxx_Sim_LineRecv(l))
+        {
+            l->phase = SIM_LINE_IDLE;
+            l->out = 1;
+        }
+        else
+        {
+            l->out = 0;
+        }
+        return;
+    }
+
+    /* Acknowledge clock done */
+    l->bit = 0;
+    l->byte = 0;
+    l->out = 1;
+
+    if (l->phase == SIM_LINE_TX)
+    {
+        if (l->nack)
+        {
+            l->phase = SIM_LINE_IDLE;
+            return;
+        }
+        l->addr = (l->addr + 1) % AT24Cxx_CAPACITY(l->sdev->type);
+    }
+    else
+    {
+        l->phase = l->next;
+    }
+
+    if (l->phase == SIM_LINE_TX)
+    {
+        l->byte = l->sdev->mem[l->addr];
+        l->out = (l->byte >> 7) & 0x01;
+    }
+}
+/**
+ * @brief  Simulated software line, master sets SDA
+ * @note   SDA falling while SCL is high is a START, rising a STOP. A STOP after
+ *         data bytes starts the page program. The SCL rise before the condition
+ *         takes its bit time.
+ */
+static void AT24Cxx_Sim_SetSda(uint8_t level)
+{
+    AT24Cxx_SIM_LINE_t *l = &AT24Cxx_SimLine;
+
+    level = level ? 1 : 0;
+    if (level == l->sda) return;
+    l->sda = level;
+
+    if (!l->scl) return;
+
+    if (!level)
+    {
+        /* START (or repeated START) */
+        AT24Cxx_Sim.transfers++;
+        l->phase = AT24Cxx_Sim.off ? SIM_LINE_IDLE : SIM_LINE_ADDR;
+        l->bit = 0;
+        l->byte = 0;
+        l->out = 1;
+        return;
+    }
+
+    /* STOP, at a byte boundary (its own SCL rise is the only clock of the frame) */
+    if (l->phase == SIM_LINE_DATA && l->bit <= 1 && l->n != 0 && !AT24Cxx_Sim.off)
+    {
+        AT24Cxx_Sim_Program(l->sdev, l->addr, l->buf, l->n);
+    }
+    l->phase = SIM_LINE_IDLE;
+    l->out = 1;
+}
+/**
+ * @brief  Simulated software line, master samples SDA
+ */
+static uint8_t AT24Cxx_Sim_GetSda(void)
+{
+    return AT24Cxx_SimLine.sda & AT24Cxx_SimLine.out;
+}
+/**
+ * @brief  Simulated software line hold time (bit time is taken per clock)
+ */
+static void AT24Cxx_Sim_Hold(uint8_t mult)
+{
+    (void)mult;
+}
+/**
+ * @brief  Simulated software line direction (open-drain, nothing to switch)
+ */
+static void AT24Cxx_Sim_Mode(IO_MODE mode)
+{
+    (void)mode;
+}
+/**
+ * @brief Simulated software i2c port (open-drain, AT24Cxx_SW_OPENDRAIN 1)
+ */
+sw_i2c_t AT24Cxx_Sim_Line =
+{
+    AT24Cxx_Sim_Hold,
+    AT24Cxx_Sim_Mode,
+    AT24Cxx_Sim_Mode,
+    AT24Cxx_Sim_SetScl,
+    AT24Cxx_Sim_SetSda,
+    AT24Cxx_Sim_GetSda
+};
+/**
+ * @brief  Simulated bus init (devices removed)
+ * @param  {uint32_t} bus_hz : SCL frequency
+ * @param  {uint32_t} twr_us : actual write cycle time (us)
+ * @param  {uint8_t} wait    : AT24Cxx_SIM_WAIT_xxx
+ * @return none
+ */
+void AT24Cxx_Sim_Init(uint32_t bus_hz, uint32_t twr_us, uint8_t wait)
+{
+    uint8_t i;
+
+    for (i = 0; i < AT24Cxx_Sim.ndev; i++)
+    {
+        free(AT24Cxx_Sim.dev[i].mem);
+        free(AT24Cxx_Sim.dev[i].wear);
+    }
+
+    memset(&AT24Cxx_Sim, 0, sizeof(AT24Cxx_Sim));
+    memset(&AT24Cxx_SimLine, 0, sizeof(AT24Cxx_SimLine));
+    AT24Cxx_SimLine.scl = AT24Cxx_SimLine.sda = AT24Cxx_SimLine.out = 1;
+    AT24Cxx_Sim.bus_hz = bus_hz;
+    AT24Cxx_Sim.twr_ns = twr_us * 1000;
+    AT24Cxx_Sim.wait = wait;
+}
+/**
+ * @brief  Simulated bus attach device
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @param  {uint8_t} hardaddr  : hardware address pins
+ * @return {AT24Cxx_SIM_DEV_t *} : device, NULL --- error
+ * @note   Memory starts erased (0xFF)
+ */
+AT24Cxx_SIM_DEV_t *AT24Cxx_Sim_Attach(AT24Cxx_CHIP type, uint8_t hardaddr)
+{
+    AT24Cxx_SIM_DEV_t *sdev;
+
+    if (AT24Cxx_Sim.ndev >= AT24Cxx_SIM_MAX_DEV) return NULL;
+
+    sdev = &AT24Cxx_Sim.dev[AT24Cxx_Sim.ndev];
+    memset(sdev, 0, sizeof(*sdev));
+    sdev->type = type;
+    sdev->hardaddr = hardaddr;
+    sdev->failpage = AT24Cxx_SIM_NOFAIL;
+    sdev->mem = (uint8_t *)malloc(AT24Cxx_CAPACITY(type));
+    sdev->wear = (uint32_t *)calloc(AT24Cxx_Sim_Pages(sdev), sizeof(uint32_t));
+    if (sdev->mem == NULL || sdev->wear == NULL)
+    {
+        free(sdev->mem);
+        free(sdev->wear);
+        return NULL;
+    }
+    memset(sdev->mem, 0xFF, AT24Cxx_CAPACITY(type));
+
+    AT24Cxx_Sim.ndev++;
+
+    return sdev;
+}
+/**
+ * @brief  Simulated bus advance time
+ * @param  {uint32_t} us : idle time (us)
+ * @return none
+ */
+void AT24Cxx_Sim_Idle(uint32_t us)
+{
+    AT24Cxx_Sim.now += (uint64_t)us * 1000;
+}
+/**
+ * @brief  Simulated bus time as a system tick
+ * @return {uint32_t} : simulated time (us), wraps like a hardware tick
+ * @note   AT24CXX_GETTICK of simulator builds with AT24Cxx_TIMEOUT_MS, the header
+ *         is included ahead of the driver (-include Port/AT24Cxx_sim.h) and
+ *         AT24Cxx_TICK_FREQ is 1000000
+ */
+uint32_t AT24Cxx_Sim_Tick(void)
+{
+    return (uint32_t)(AT24Cxx_Sim.now / 1000);
+}
+/**
+ * @brief  Simulated device number of pages
+ * @param  {AT24Cxx_SIM_DEV_t} *sdev : device
+ * @return {uint32_t}                : number of pages
+ */
+uint32_t AT24Cxx_Sim_Pages(AT24Cxx_SIM_DEV_t *sdev)
+{
+    return AT24Cxx_CAPACITY(sdev->type) / AT24Cxx_PAGESIZE(sdev->type);
+}
+/**
+ * @brief  Simulated bus arm power loss at a bus byte
+ * @param  {uint64_t} n : power is lost in the n-th next byte on the bus (1 --- next byte)
+ * @return none
+ * @note   The transfer holding that byte fails and never reaches memory
+ */
+void AT24Cxx_Sim_CutAtByte(uint64_t n)
+{
+    AT24Cxx_Sim.cutbyte = n;
+}
+/**
+ * @brief  Simulated bus arm power loss in a write cycle
+ * @param  {uint32_t} n    : power is lost in the write cycle of the n-th next page program (1 --- next)
+ * @param  {uint32_t} keep : bytes of that program already in memory (0 --- page unchanged)
+ * @return none
+ * @note   The interrupted program is still acknowledged
+ */
+void AT24Cxx_Sim_CutAtProgram(uint32_t n, uint32_t keep)
+{
+    AT24Cxx_Sim.cutprog = n;
+    AT24Cxx_Sim.cutkeep = keep;
+}
+/**
+ * @brief  Simulated bus restore power
+ * @return none
+ * @note   Devices come up idle, armed cuts are cleared
+ */
+void AT24Cxx_Sim_PowerOn(void)
+{
+    uint8_t i;
+
+    AT24Cxx_Sim.off = 0;
+    AT24Cxx_Sim.cutbyte = 0;
+    AT24Cxx_Sim.cutprog = 0;
+    AT24Cxx_SimLine.phase = SIM_LINE_IDLE;
+    AT24Cxx_SimLine.out = 1;
+
+    for (i = 0; i < AT24Cxx_Sim.ndev; i++)
+    {
+        AT24Cxx_Sim.dev[i].busy = 0;
+    }
+}
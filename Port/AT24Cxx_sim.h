@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_sim.h
+ * @brief   Simulated i2c bus (hardware port and software line model) and AT24Cxx devices header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+**/
+#ifndef __AT24CXX_SIM_H
+#define __AT24CXX_SIM_H
+#include "AT24Cxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of simulated devices on the bus
+ */
+#define AT24Cxx_SIM_MAX_DEV         8
+
+/**
+ * @brief Write cycle wait model
+ * 0 : fixed 5ms after every page program (AT24CXX_WCYCLEMS)
+ * 1 : acknowledge polling until the actual write cycle time has elapsed
+ * 2 : none, the driver waits itself (AT24CXX_WCYCLEMS calling AT24Cxx_Sim_Idle)
+ */
+#define AT24Cxx_SIM_WAIT_FIXED      0
+#define AT24Cxx_SIM_WAIT_ACKPOLL    1
+#define AT24Cxx_SIM_WAIT_NONE       2
+
+/**
+ * @brief No page has exceeded its endurance
+ */
+#define AT24Cxx_SIM_NOFAIL          0xFFFFFFFFUL
+
+/**
+ * @brief Simulated device
+ */
+typedef struct
+{
+    AT24Cxx_CHIP type;
+    uint8_t hardaddr;               /* hardware address pins (A2 A1 A0) */
+    uint8_t *mem;                   /* memory array */
+    uint32_t *wear;                 /* program count per page */
+    uint64_t busy;                  /* end of the self-timed write cycle (ns) */
+    uint32_t reads;                 /* read transfers */
+    uint32_t programs;              /* page programs (write cycles) */
+    uint64_t rbytes;                /* bytes read */
+    uint64_t wbytes;                /* bytes programmed */
+    uint32_t nacks;                 /* transfers refused while busy */
+    uint64_t failtime;              /* time the first page exceeded its endurance (ns) */
+    uint32_t failpage;              /* first page exceeding its endurance, AT24Cxx_SIM_NOFAIL --- none */
+} AT24Cxx_SIM_DEV_t;
+
+/**
+ * @brief Simulated bus
+ */
+typedef struct
+{
+    uint64_t now;                   /* simulated time (ns) */
+    uint32_t bus_hz;                /* SCL frequency */
+    uint32_t twr_ns;                /* actual write cycle time */
+    uint32_t endurance;             /* rated write cycles per page, 0 --- unlimited */
+    uint8_t wait;                   /* AT24Cxx_SIM_WAIT_xxx */
+    uint8_t off;                    /* power is lost, every transfer fails */
+    uint64_t bytes;                 /* bytes on the bus */
+    uint64_t transfers;             /* transfers on the bus (START to STOP) */
+    uint64_t cutbyte;               /* power is lost in the n-th next bus byte, 0 --- disarmed */
+    uint32_t cutprog;               /* power is lost in the write cycle of the n-th next program, 0 --- disarmed */
+    uint32_t cutkeep;               /* bytes of the interrupted program already in memory */
+    uint8_t ndev;
+    AT24Cxx_SIM_DEV_t dev[AT24Cxx_SIM_MAX_DEV];
+} AT24Cxx_SIM_t;
+
+/**
+ * @brief Simulated i2c ports and their state
+ * Port callbacks carry no context, there is one simulated bus. The software
+ * port models the SCL and SDA lines and needs AT24Cxx_SW_OPENDRAIN on a host
+ * (the bus_i2c stub has no bit-bang routines).
+ */
+extern hw_i2c_t AT24Cxx_Sim_Bus;
+extern sw_i2c_t AT24Cxx_Sim_Line;
+extern AT24Cxx_SIM_t AT24Cxx_Sim;
+
+/**
+ * @brief Simulated port of the configured bus mode (at24cxx_t port.bus)
+ */
+#if AT24Cxx_I2C_MODE == 0
+#define AT24Cxx_SIM_PORT            (&AT24Cxx_Sim_Line)
+#else
+#define AT24Cxx_SIM_PORT            (&AT24Cxx_Sim_Bus)
+#endif
+
+void AT24Cxx_Sim_Init(uint32_t bus_hz, uint32_t twr_us, uint8_t wait);                    /* Reset bus, remove devices */
+AT24Cxx_SIM_DEV_t *AT24Cxx_Sim_Attach(AT24Cxx_CHIP type, uint8_t hardaddr);               /* Add device (erased, 0xFF) */
+void AT24Cxx_Sim_Idle(uint32_t us);                                                       /* Advance simulated time */
+uint32_t AT24Cxx_Sim_Tick(void);                                                          /* Simulated time (us), tick source */
+uint32_t AT24Cxx_Sim_Pages(AT24Cxx_SIM_DEV_t *sdev);                                      /* Number of pages */
+void AT24Cxx_Sim_CutAtByte(uint64_t n);                                                   /* Lose power in the n-th next bus byte */
+void AT24Cxx_Sim_CutAtProgram(uint32_t n, uint32_t keep);                                 /* Lose power in the n-th next write cycle */
+void AT24Cxx_Sim_PowerOn(void);                                                           /* Restore power, disarm cuts */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    bus_i2c.h
+ * @brief   Host stub of the bus_i2c interface for the Port and Tools builds
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * AT24Cxx.h includes "bus_i2c.h" of the target project, which is not part of
+ * this repository. This stub carries only the port types and helpers the driver
+ * uses, so the host ports and tools build from a clean tree with -IPort/host.
+ * The swi2c_* routines are declared, not implemented : a software bus build
+ * with AT24Cxx_SW_OPENDRAIN set to 0 still needs the real bus_i2c.
+**/
+#ifndef __BUS_I2C_H
+#define __BUS_I2C_H
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Line direction, acknowledge level
+ */
+typedef enum
+{
+    IN = 0,
+    OUT = 1
+} IO_MODE;
+
+#define ACK                         0
+#define NACK                        1
+
+/**
+ * @brief Bytes of a 16 bit value
+ */
+#define LSB_16(x)                   ((uint8_t)((x) & 0xFF))
+#define MSB_16(x)                   ((uint8_t)(((x) >> 8) & 0xFF))
+
+/**
+ * @brief Hardware i2c bus port (master mode)
+ */
+typedef struct
+{
+    uint8_t(*send)(uint16_t devaddr, uint8_t *pdata, uint32_t size);
+    uint8_t(*recv)(uint16_t devaddr, uint8_t *pdata, uint32_t size);
+    uint8_t(*wmem)(uint16_t devaddr, uint16_t memaddr, uint8_t memaddrsize, uint8_t *pdata, uint32_t size);
+    uint8_t(*rmem)(uint16_t devaddr, uint16_t memaddr, uint8_t memaddrsize, uint8_t *pdata, uint32_t size);
+} hw_i2c_t;
+
+/**
+ * @brief Software i2c bus port (master mode)
+ */
+typedef struct
+{
+    void (*holdtime)(uint8_t mult);
+    void (*sda_mode)(IO_MODE mode);
+    void (*scl_mode)(IO_MODE mode);
+    void (*set_scl)(uint8_t level);
+    void (*set_sda)(uint8_t level);
+    uint8_t(*get_sda)(void);
+} sw_i2c_t;
+
+void swi2c_config(sw_i2c_t *bus);
+void swi2c_reset(sw_i2c_t *bus);
+void swi2c_strt(sw_i2c_t *bus);
+void swi2c_stop(sw_i2c_t *bus);
+uint8_t swi2c_waddr(sw_i2c_t *bus, uint8_t addr);
+uint8_t swi2c_raddr(sw_i2c_t *bus, uint8_t addr);
+uint8_t swi2c_wbyte(sw_i2c_t *bus, uint8_t byte);
+uint8_t swi2c_rbyte(sw_i2c_t *bus, uint8_t ack);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
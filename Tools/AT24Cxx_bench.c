@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_bench.c
+ * @brief   Host microbenchmark of driver CPU cost with an instant bus
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * The bus does nothing and the write cycle delay is removed, so only the
+ * CPU cost of the driver (address setup, page split, bit-bang loops) is measured.
+ *
+ * Hardware i2c path :
+ *   cc -O2 -I. -IPort/host -IPort -ITools -D'AT24CXX_WCYCLEMS=' Tools/AT24Cxx_bench.c Tools/AT24Cxx_trace.c AT24Cxx.c -o at24cxx_bench
+ * Software i2c path (driver open-drain bit-bang) :
+ *   cc -O2 -I. -IPort/host -IPort -ITools -D'AT24CXX_WCYCLEMS=' -DAT24Cxx_I2C_MODE=0 -DAT24Cxx_SW_OPENDRAIN=1 Tools/AT24Cxx_bench.c Tools/AT24Cxx_trace.c AT24Cxx.c -o at24cxx_bench
+ * Software i2c path (bus_i2c bit-bang) :
+ *   cc -O2 -I. -IPort -ITools -D'AT24CXX_WCYCLEMS=' -DAT24Cxx_I2C_MODE=0 Tools/AT24Cxx_bench.c Tools/AT24Cxx_trace.c AT24Cxx.c bus_i2c.c -o at24cxx_bench
+**/
+
+#define _DEFAULT_SOURCE
+#include "AT24Cxx_trace.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Minimum measuring time of one case (s) */
+#define BENCH_MIN_TIME      0.05
+
+static uint8_t buf[4096];
+static volatile uint32_t sink;
+
+/*------------------------------------------------------*/
+/*                  Instant bus backend                 */
+/*------------------------------------------------------*/
+#if AT24Cxx_I2C_MODE == 0
+static void null_hold(uint8_t mult) { (void)mult; }
+static void null_mode(IO_MODE mode) { (void)mode; }
+static void null_level(uint8_t level) { sink += level; }
+static uint8_t null_get(void) { return 0; }
+
+static sw_i2c_t bench_bus = { null_hold, null_mode, null_mode, null_level, null_level, null_get };
+#else
+static uint8_t null_xfer(uint16_t devaddr, uint8_t *pdata, uint32_t size) { (void)pdata; sink += devaddr + size; return 0; }
+static uint8_t null_mem(uint16_t devaddr, uint16_t memaddr, uint8_t memaddrsize, uint8_t *pdata, uint32_t size) { (void)pdata; sink += devaddr + memaddr + memaddrsize + size; return 0; }
+
+static hw_i2c_t bench_bus = { null_xfer, null_xfer, null_mem, null_mem };
+#endif
+
+/**
+ * @brief  Get monotonic time
+ * @return {double} : time (s)
+ */
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+/**
+ * @brief  Run one benchmark case
+ * @param  {at24cxx_t} *dev : device
+ * @param  {char} op        : 'A' address, 'R' read, 'W' write, 'E' erase
+ * @param  {uint32_t} size  : data size
+ * @return {double}         : ns per operation
+ * @note   Addresses walk through the chip so every block and page offset is hit
+ */
+static double bench_case(at24cxx_t *dev, char op, uint32_t size)
+{
+    uint32_t cap = AT24Cxx_CAPACITY(dev->info.type);
+    uint32_t n = 0, batch = 64, i, addr = 0;
+    uint8_t asize;
+    double t0 = bench_now(), t;
+
+    do
+    {
+        for (i = 0; i < batch; i++)
+        {
+            addr = (addr + 37) % (cap - size + 1);
+            switch (op)
+            {
+                case 'A': sink += AT24Cxx_GetDevAddress(dev, addr, &asize); break;
+                case 'R': AT24Cxx_Read(dev, addr, buf, size); break;
+                case 'W': AT24Cxx_Write(dev, addr, buf, size); break;
+                case 'E': AT24Cxx_Erase(dev, addr, 0xFF, size); break;
+                default: break;
+            }
+        }
+        n += batch;
+        t = bench_now() - t0;
+    } while (t < BENCH_MIN_TIME);
+
+    return t * 1e9 / n;
+}
+int main(void)
+{
+    static const char ops[] = { 'A', 'R', 'W', 'E' };
+    static const uint32_t sizes[] = { 1, 16, 256, 4096 };
+    at24cxx_t dev;
+    double ns;
+    int c, o, s;
+
+    memset(&dev, 0, sizeof(dev));
+    dev.port.bus = &bench_bus;
+
+    printf("bus : %s\n", AT24Cxx_I2C_MODE == 0 ? (AT24Cxx_SW_OPENDRAIN ? "software (open-drain)" : "software (bus_i2c)") : "hardware");
+    printf("%-9s %-2s %6s %12s %12s\n", "chip", "op", "size", "ns/op", "ops/s");
+
+    for (c = AT24C01; c <= AT24CM02; c++)
+    {
+        AT24Cxx_config(&dev, (AT24Cxx_CHIP)c, 0x0A, 0x00);
+
+        for (o = 0; o < 4; o++)
+        {
+            for (s = 0; s < 4; s++)
+            {
+                if (sizes[s] > AT24Cxx_CAPACITY(c)) continue;
+                if (ops[o] == 'A' && s > 0) continue;
+
+                ns = bench_case(&dev, ops[o], sizes[s]);
+                printf("%-9s %-2c %6u %12.1f %12.0f\n", AT24Cxx_Trace_ChipName[c - 1], ops[o], sizes[s], ns, 1e9 / ns);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,756 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_check.c
+ * @brief   Checks of the driver layers on the simulated bus
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * Every check mounts a fresh simulated device and compares the driver against the
+ * simulated memory, page programs and bus reads : record layout placement, persistent
+ * variables, the asynchronous run budget, cache coherence, the shadow, the lazy write
+ * cycle, deferred writes, transactions under power loss, write cycle timeouts, preload
+ * readiness, the boot region and versioned records. Each check of each chip type runs
+ * in its own process (the simulated bus and the arena are global). Checks of layers
+ * that are not built in are shown as '-'.
+ *
+ * Build : cc -O2 -I. -IPort/host -IPort -ITools -D'AT24CXX_WCYCLEMS=' Tools/AT24Cxx_check.c Tools/AT24Cxx_trace.c Port/AT24Cxx_sim.c AT24Cxx.c -o at24cxx_check
+ * All layers : add -DAT24Cxx_CACHE_SETS=16 -DAT24Cxx_DEFER_PAGES=8 -DAT24Cxx_LAZY_WCYCLE=1 -DAT24Cxx_TIMEOUT_MS=20 -DAT24Cxx_TICK_FREQ=1000000 -D'AT24CXX_GETTICK()=AT24Cxx_Sim_Tick()' -include Port/AT24Cxx_sim.h -DAT24Cxx_ARENA_SIZE=65536
+ * Software bus : add -DAT24Cxx_I2C_MODE=0 -DAT24Cxx_SW_OPENDRAIN=1
+ * Usage : at24cxx_check [-c chip]
+**/
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#include "AT24Cxx_sim.h"
+#include "AT24Cxx_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* Tool Function */
+#define min(a, b)           (((a) < (b)) ? (a) : (b))       /* Take the minimum value */
+
+/* Check result */
+#define CHECK_OK            0
+#define CHECK_FAIL          1
+#define CHECK_NOTBUILT      2
+
+static at24cxx_t dev;
+static AT24Cxx_SIM_DEV_t *sdev;
+static uint8_t ref[262144];
+static uint8_t buf[262144];
+
+/**
+ * @brief  Random number (xorshift64)
+ * @return {uint32_t} : random number
+ */
+static uint32_t check_rand(void)
+{
+    static uint64_t x = 88172645463325252ULL;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+
+    return (uint32_t)(x >> 32);
+}
+/**
+ * @brief  Mount a fresh simulated device
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @param  {uint32_t} twr_us   : actual write cycle time
+ * @param  {uint8_t} wait      : AT24Cxx_SIM_WAIT_xxx
+ * @return none
+ */
+static void check_mount(AT24Cxx_CHIP type, uint32_t twr_us, uint8_t wait)
+{
+    AT24Cxx_Sim_Init(400000, twr_us, wait);
+    sdev = AT24Cxx_Sim_Attach(type, 0);
+
+    memset(&dev, 0, sizeof(dev));
+    dev.port.bus = AT24Cxx_SIM_PORT;
+    AT24Cxx_config(&dev, type, 0x0A, 0);
+
+    memset(ref, 0xFF, AT24Cxx_CAPACITY(type));
+}
+/**
+ * @brief  Fill a buffer with random data
+ * @param  {uint8_t} *data : buffer
+ * @param  {uint32_t} size : size
+ * @return none
+ */
+static void check_fill(uint8_t *data, uint32_t size)
+{
+    while (size--) *data++ = (uint8_t)check_rand();
+}
+/*------------------------------------------------------*/
+/*                        Checks                        */
+/*------------------------------------------------------*/
+/**
+ * @brief  Planned records are disjoint, a saved record costs its planned cycles
+ *         and only records of the same frequency class share a page
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_layout(AT24Cxx_CHIP type)
+{
+    AT24Cxx_RECORD_t rec[6];
+    uint32_t ps, end, cost = 0, p0, i, j;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    ps = dev.info.pagesize;
+
+    rec[0].size = 1;          rec[0].freq = 60;
+    rec[1].size = ps / 2 + 1; rec[1].freq = 10;
+    rec[2].size = ps;         rec[2].freq = 1;
+    rec[3].size = ps + 3;     rec[3].freq = 60;
+    rec[4].size = 2 * ps + 1; rec[4].freq = 1;
+    rec[5].size = 3;          rec[5].freq = 10;
+
+    if (AT24Cxx_Layout_Plan(&dev, rec, 6, 1, &end) != 0) return CHECK_FAIL;
+    if (end > AT24Cxx_CAPACITY(type)) return CHECK_FAIL;
+
+    for (i = 0; i < 6; i++)
+    {
+        if (rec[i].addr < ps || rec[i].addr + rec[i].size > end) return CHECK_FAIL;
+        if (rec[i].size <= ps && rec[i].cycles != 1) return CHECK_FAIL;
+        cost += rec[i].freq * rec[i].cycles;
+
+        for (j = 0; j < i; j++)
+        {
+            /* Disjoint, a shared page holds one frequency class */
+            if (rec[i].addr < rec[j].addr + rec[j].size && rec[j].addr < rec[i].addr + rec[i].size) return CHECK_FAIL;
+            if (rec[i].freq != rec[j].freq &&
+                rec[i].addr / ps <= (rec[j].addr + rec[j].size - 1) / ps &&
+                rec[j].addr / ps <= (rec[i].addr + rec[i].size - 1) / ps) return CHECK_FAIL;
+        }
+    }
+    if (AT24Cxx_Layout_Cost(&dev, rec, 6) != cost) return CHECK_FAIL;
+
+    /* Save every record on the bus */
+    for (i = 0; i < 6; i++)
+    {
+        check_fill(ref + rec[i].addr, rec[i].size);
+        p0 = sdev->programs;
+        if (AT24Cxx_Write(&dev, rec[i].addr, ref + rec[i].addr, rec[i].size) != 0) return CHECK_FAIL;
+        if (sdev->programs - p0 != rec[i].cycles) return CHECK_FAIL;
+    }
+
+    return memcmp(sdev->mem, ref, end) == 0 ? CHECK_OK : CHECK_FAIL;
+}
+/**
+ * @brief  A persistent variable loads once and commits changed pages only
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_var(AT24Cxx_CHIP type)
+{
+    static uint8_t val[8];
+    static AT24Cxx_VAR_t var = AT24Cxx_VAR_INIT(0, val);
+    uint8_t next[8];
+    uint32_t p0, r0;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    var.addr = dev.info.pagesize - 3;                   /* two pages */
+    check_fill(sdev->mem + var.addr, sizeof(val));
+
+    r0 = sdev->reads;
+    if (AT24Cxx_Var_Get(&dev, &var) == NULL || memcmp(val, sdev->mem + var.addr, sizeof(val)) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Var_Get(&dev, &var) == NULL || sdev->reads - r0 != 1) return CHECK_FAIL;
+
+    /* Change one byte of the second page */
+    memcpy(next, val, sizeof(next));
+    next[6] ^= 0x5A;
+    p0 = sdev->programs;
+    if (AT24Cxx_Var_Set(&dev, &var, next) != 0 || AT24Cxx_Var_Commit(&dev, &var) != 0) return CHECK_FAIL;
+    if (sdev->programs - p0 != 1 || memcmp(sdev->mem + var.addr, next, sizeof(next)) != 0) return CHECK_FAIL;
+
+    /* Same value, nothing to program */
+    p0 = sdev->programs;
+    if (AT24Cxx_Var_Set(&dev, &var, next) != 0 || AT24Cxx_Var_Commit(&dev, &var) != 0) return CHECK_FAIL;
+
+    return sdev->programs == p0 ? CHECK_OK : CHECK_FAIL;
+}
+/**
+ * @brief  Advance an operation and finish its write cycle
+ * @param  {AT24Cxx_OP_t} *op : operation
+ * @param  {uint16_t} pages   : page budget
+ * @return {AT24Cxx_OPSTATE}  : state
+ */
+static AT24Cxx_OPSTATE check_run(AT24Cxx_OP_t *op, uint16_t pages)
+{
+    AT24Cxx_OPSTATE st = AT24Cxx_Async_Run(op, pages, 0);
+
+#if AT24Cxx_ASYNC_ACKPOLL == 0
+    if (st == AT24Cxx_OP_WAIT)
+    {
+        AT24Cxx_Sim_Idle(3500);
+        AT24Cxx_Async_Resume(op);
+    }
+#endif
+
+    return st;
+}
+/**
+ * @brief  A one page budget moves an operation by one page, cancel keeps the progress
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_async(AT24Cxx_CHIP type)
+{
+    AT24Cxx_OP_t op;
+    AT24Cxx_OPSTATE st;
+    uint32_t ps, addr, size, remain, p0;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_NONE);
+    ps = dev.info.pagesize;
+    addr = ps / 2;
+    size = min(3 * ps, AT24Cxx_CAPACITY(type) - addr);
+    check_fill(ref + addr, size);
+    memset(&op, 0, sizeof(op));
+
+    if (AT24Cxx_Async_Write(&op, &dev, addr, ref + addr, size) != 0) return CHECK_FAIL;
+    do
+    {
+        remain = op.remain;
+        p0 = sdev->programs;
+        st = check_run(&op, 1);
+        if (remain - op.remain > ps || sdev->programs - p0 > 1) return CHECK_FAIL;
+        AT24Cxx_Sim_Idle(100);
+    } while (st == AT24Cxx_OP_BUSY || st == AT24Cxx_OP_WAIT);
+    if (st != AT24Cxx_OP_DONE || memcmp(sdev->mem + addr, ref + addr, size) != 0) return CHECK_FAIL;
+
+    if (AT24Cxx_Async_Verify(&op, &dev, addr, ref + addr, 0, size) != 0) return CHECK_FAIL;
+    while ((st = check_run(&op, 0)) == AT24Cxx_OP_BUSY || st == AT24Cxx_OP_WAIT);
+    if (st != AT24Cxx_OP_DONE) return CHECK_FAIL;
+
+    /* Cancel after the first page */
+    AT24Cxx_Sim_Idle(10000);
+    if (AT24Cxx_Async_Erase(&op, &dev, addr, 0x00, size) != 0) return CHECK_FAIL;
+    check_run(&op, 1);
+    AT24Cxx_Async_Cancel(&op);
+    while ((st = check_run(&op, 0)) == AT24Cxx_OP_BUSY || st == AT24Cxx_OP_WAIT);
+    if (st != AT24Cxx_OP_CANCEL || op.remain == 0 || op.addr != addr + size - op.remain) return CHECK_FAIL;
+    memset(ref + addr, 0x00, size - op.remain);
+
+    return memcmp(sdev->mem + addr, ref + addr, size) == 0 ? CHECK_OK : CHECK_FAIL;
+}
+/**
+ * @brief  Reads through the page cache match the memory after every kind of write
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_cache(AT24Cxx_CHIP type)
+{
+#if AT24Cxx_CACHE_SETS != 0
+    AT24Cxx_OP_t op;
+    AT24Cxx_OPSTATE st;
+    uint32_t win, addr, size, hits, misses, i;
+    uint8_t fdata;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    if (AT24Cxx_Cache_Init(&dev) != 0) return CHECK_FAIL;
+    win = min(16 * (uint32_t)dev.info.pagesize, AT24Cxx_CAPACITY(type));
+    memset(&op, 0, sizeof(op));
+
+    for (i = 0; i < 2000; i++)
+    {
+        addr = check_rand() % win;
+        size = 1 + check_rand() % min(win - addr, 2 * (uint32_t)dev.info.pagesize);
+
+        switch (check_rand() % 6)
+        {
+            case 0:
+            case 1: {
+                if (AT24Cxx_Read(&dev, addr, buf, size) != 0 || memcmp(buf, ref + addr, size) != 0) return CHECK_FAIL;
+                break;}
+            case 2: {
+                check_fill(ref + addr, size);
+                if (AT24Cxx_Write(&dev, addr, ref + addr, size) != 0) return CHECK_FAIL;
+                break;}
+            case 3: {
+                fdata = (uint8_t)check_rand();
+                memset(ref + addr, fdata, size);
+                if (AT24Cxx_Erase(&dev, addr, fdata, size) != 0) return CHECK_FAIL;
+                break;}
+            case 4: {
+                check_fill(ref + addr, size);
+                if (AT24Cxx_Async_Write(&op, &dev, addr, ref + addr, size) != 0) return CHECK_FAIL;
+                while ((st = check_run(&op, 0)) == AT24Cxx_OP_BUSY || st == AT24Cxx_OP_WAIT);
+                if (st != AT24Cxx_OP_DONE) return CHECK_FAIL;
+                break;}
+            default: {
+                /* Changed behind the driver */
+                check_fill(ref + addr, size);
+                memcpy(sdev->mem + addr, ref + addr, size);
+                AT24Cxx_Cache_Invalidate(&dev);
+                break;}
+        }
+    }
+
+    AT24Cxx_Cache_Stats(&dev, &hits, &misses);
+    if (hits == 0 || memcmp(sdev->mem, ref, win) != 0) return CHECK_FAIL;
+
+    return CHECK_OK;
+#else
+    (void)type;
+
+    return CHECK_NOTBUILT;
+#endif
+}
+/**
+ * @brief  Shadow reads see a write only after it reached the memory
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_shadow(AT24Cxx_CHIP type)
+{
+    AT24Cxx_SHADOW_t sh;
+    uint32_t addr;
+    uint8_t val[4], old[4];
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    addr = dev.info.pagesize / 2;
+    check_fill(sdev->mem + addr, 16);
+    if (AT24Cxx_Shadow_Init(&sh, &dev, addr, 16) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Shadow_Read(&sh, 0, buf, 16) != 0 || memcmp(buf, sdev->mem + addr, 16) != 0) return CHECK_FAIL;
+
+    check_fill(val, sizeof(val));
+    if (AT24Cxx_Shadow_Write(&sh, 6, val, sizeof(val)) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Shadow_Read(&sh, 6, old, sizeof(old)) != 0 || memcmp(old, val, sizeof(val)) != 0) return CHECK_FAIL;
+    if (memcmp(sdev->mem + addr + 6, val, sizeof(val)) != 0) return CHECK_FAIL;
+
+    /* Failed write, readers keep the previous data */
+    check_fill(val, sizeof(val));
+    AT24Cxx_Sim_CutAtByte(1);
+    if (AT24Cxx_Shadow_Write(&sh, 6, val, sizeof(val)) == 0) return CHECK_FAIL;
+    AT24Cxx_Sim_PowerOn();
+    if (AT24Cxx_Shadow_Read(&sh, 0, buf, 16) != 0 || memcmp(buf, sdev->mem + addr, 16) != 0) return CHECK_FAIL;
+
+    return CHECK_OK;
+}
+/**
+ * @brief  A lazy write returns in the write cycle, its bytes are read from RAM
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_lazy(AT24Cxx_CHIP type)
+{
+#if AT24Cxx_LAZY_WCYCLE != 0 && AT24Cxx_TIMEOUT_MS != 0
+    uint32_t ps, r0;
+    uint64_t t0;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_NONE);
+    if (AT24Cxx_Lazy_Init(&dev) != 0) return CHECK_FAIL;
+    ps = dev.info.pagesize;
+
+    check_fill(ref, 4);
+    t0 = AT24Cxx_Sim.now;
+    if (AT24Cxx_Write(&dev, 0, ref, 4) != 0 || AT24Cxx_Sim.now - t0 >= 3500000) return CHECK_FAIL;
+
+    r0 = sdev->reads;
+    if (AT24Cxx_Read(&dev, 0, buf, 4) != 0 || memcmp(buf, ref, 4) != 0 || sdev->reads != r0) return CHECK_FAIL;
+
+    /* Another page waits for the write cycle */
+    if (AT24Cxx_Read(&dev, min(2 * ps, AT24Cxx_CAPACITY(type) - 4), buf, 4) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Sim.now - t0 < 3500000) return CHECK_FAIL;
+
+    check_fill(ref + ps, 4);
+    if (AT24Cxx_Write(&dev, ps, ref + ps, 4) != 0 || AT24Cxx_Lazy_Sync(&dev) != 0) return CHECK_FAIL;
+
+    return memcmp(sdev->mem, ref, 2 * ps) == 0 ? CHECK_OK : CHECK_FAIL;
+#else
+    (void)type;
+
+    return CHECK_NOTBUILT;
+#endif
+}
+/**
+ * @brief  Deferred writes program each staged page once, full pages on idle
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_defer(AT24Cxx_CHIP type)
+{
+#if AT24Cxx_DEFER_PAGES != 0
+    uint32_t ps, p0, i;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    if (AT24Cxx_Defer_Init(&dev) != 0) return CHECK_FAIL;
+    ps = dev.info.pagesize;
+    p0 = sdev->programs;
+
+    /* A page filled piece by piece */
+    check_fill(ref, ps);
+    for (i = 0; i < ps; i += 4)
+    {
+        if (AT24Cxx_Write(&dev, i, ref + i, min(4, ps - i)) != 0) return CHECK_FAIL;
+    }
+    if (sdev->programs != p0) return CHECK_FAIL;
+    if (AT24Cxx_Read(&dev, 0, buf, ps) != 0 || memcmp(buf, ref, ps) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Defer_Idle(&dev, 1) != 0 || sdev->programs - p0 != 1) return CHECK_FAIL;
+
+    /* Partial pages keep the unstaged bytes */
+    check_fill(sdev->mem + ps, 3 * ps);
+    memcpy(ref + ps, sdev->mem + ps, 3 * ps);
+    check_fill(ref + ps + 1, 2);
+    check_fill(ref + 3 * ps - 2, 4);
+    if (AT24Cxx_Write(&dev, ps + 1, ref + ps + 1, 2) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Write(&dev, 3 * ps - 2, ref + 3 * ps - 2, 4) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Defer_Idle(&dev, 1) != 0 || sdev->programs - p0 != 1) return CHECK_FAIL;
+    if (AT24Cxx_Read(&dev, ps, buf, 3 * ps) != 0 || memcmp(buf, ref + ps, 3 * ps) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Defer_Flush(&dev) != 0 || sdev->programs - p0 != 4) return CHECK_FAIL;
+
+    return memcmp(sdev->mem, ref, 4 * ps) == 0 ? CHECK_OK : CHECK_FAIL;
+#else
+    (void)type;
+
+    return CHECK_NOTBUILT;
+#endif
+}
+#if AT24Cxx_DEFER_PAGES != 0
+/**
+ * @brief  Collect the writes of the transaction under check
+ * @param  {uint32_t} ps : page size
+ * @return {uint8_t}     : 0 --- success
+ */
+static uint8_t check_txn_writes(uint32_t ps)
+{
+    uint32_t f;
+    uint8_t rsp = AT24Cxx_Txn_Begin(&dev);
+
+    /* 12 fields over 3 pages, one erase */
+    for (f = 0; f < 12; f++)
+    {
+        rsp |= AT24Cxx_Write(&dev, (f % 3) * ps + (f / 3) * 2, ref + (f % 3) * ps + (f / 3) * 2, 2);
+    }
+    rsp |= AT24Cxx_Erase(&dev, ps - 2, ref[ps - 2], 2);
+
+    return rsp;
+}
+#endif
+/**
+ * @brief  A commit programs each page once and is all or nothing under power loss
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_txn(AT24Cxx_CHIP type)
+{
+#if AT24Cxx_DEFER_PAGES != 0
+    static uint8_t old[262144];
+    uint32_t ps, cap, jaddr, jsize, p0, n, programs, bytes, step, f;
+    uint8_t rsp;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    if (AT24Cxx_Defer_Init(&dev) != 0) return CHECK_FAIL;
+    ps = dev.info.pagesize;
+    cap = AT24Cxx_CAPACITY(type);
+
+    check_fill(sdev->mem, 3 * ps);
+    memcpy(old, sdev->mem, 3 * ps);
+    memcpy(ref, old, 3 * ps);
+    for (f = 0; f < 12; f++) check_fill(ref + (f % 3) * ps + (f / 3) * 2, 2);
+    ref[ps - 1] = ref[ps - 2] = 0x00;
+
+    /* Without journal */
+    p0 = sdev->programs;
+    if (check_txn_writes(ps) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Read(&dev, 0, buf, 3 * ps) != 0 || memcmp(buf, ref, 3 * ps) != 0) return CHECK_FAIL;
+    if (sdev->programs != p0 || AT24Cxx_Txn_Commit(&dev) != 0) return CHECK_FAIL;
+    if (sdev->programs - p0 != 3 || memcmp(sdev->mem, ref, 3 * ps) != 0) return CHECK_FAIL;
+
+    /* Journal at the end of the chip */
+    jsize = (8 + (6 + ps) * AT24Cxx_DEFER_PAGES + ps - 1) / ps * ps;
+    if (jsize + 3 * ps > cap) return CHECK_OK;
+    jaddr = cap - jsize;
+    if (AT24Cxx_Txn_Journal(&dev, jaddr, jsize) != 0 || AT24Cxx_Txn_Recover(&dev) != 0) return CHECK_FAIL;
+
+    memcpy(sdev->mem, old, 3 * ps);
+    p0 = sdev->programs;
+    bytes = (uint32_t)AT24Cxx_Sim.bytes;
+    if (check_txn_writes(ps) != 0 || AT24Cxx_Txn_Commit(&dev) != 0) return CHECK_FAIL;
+    programs = sdev->programs - p0;
+    bytes = (uint32_t)AT24Cxx_Sim.bytes - bytes;
+    if (memcmp(sdev->mem, ref, 3 * ps) != 0) return CHECK_FAIL;
+
+    /* Cut in every write cycle and at bus bytes, recover to all old or all new */
+    step = bytes / 64 + 1;
+    for (n = 1; n <= programs + bytes; n += (n <= programs) ? 1 : step)
+    {
+        memcpy(sdev->mem, old, 3 * ps);
+        if (check_txn_writes(ps) != 0) return CHECK_FAIL;
+
+        if (n <= programs) AT24Cxx_Sim_CutAtProgram(n, ps / 2);
+        else AT24Cxx_Sim_CutAtByte(n - programs);
+        rsp = AT24Cxx_Txn_Commit(&dev);
+        AT24Cxx_Sim_PowerOn();
+
+        if (rsp != 0) AT24Cxx_Txn_Abort(&dev);
+        if (AT24Cxx_Txn_Recover(&dev) != 0) return CHECK_FAIL;
+        if (memcmp(sdev->mem, old, 3 * ps) != 0 && memcmp(sdev->mem, ref, 3 * ps) != 0) return CHECK_FAIL;
+    }
+
+    return CHECK_OK;
+#else
+    (void)type;
+
+    return CHECK_NOTBUILT;
+#endif
+}
+/**
+ * @brief  A write cycle that never ends times out and the device is usable after it
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_timeout(AT24Cxx_CHIP type)
+{
+#if AT24Cxx_TIMEOUT_MS != 0
+    uint64_t t0;
+
+    check_mount(type, 100000, AT24Cxx_SIM_WAIT_NONE);
+    AT24Cxx_SetTimeout(&dev, 20);
+
+    check_fill(ref, 4);
+    t0 = AT24Cxx_Sim.now;
+    if (AT24Cxx_Write(&dev, 0, ref, 4) != AT24Cxx_ETIMEOUT) return CHECK_FAIL;
+    if (AT24Cxx_Sim.now - t0 < 20000000 || AT24Cxx_Sim.now - t0 >= 100000000) return CHECK_FAIL;
+
+    AT24Cxx_Sim_Idle(100000);
+    if (AT24Cxx_Read(&dev, 0, buf, 4) != 0 || memcmp(buf, ref, 4) != 0) return CHECK_FAIL;
+
+    return CHECK_OK;
+#else
+    (void)type;
+
+    return CHECK_NOTBUILT;
+#endif
+}
+/**
+ * @brief  A preload range is ready once read, never outside the read
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_preload(AT24Cxx_CHIP type)
+{
+    AT24Cxx_OP_t op;
+    AT24Cxx_OPSTATE st;
+    uint32_t ps, addr, size;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    ps = dev.info.pagesize;
+    addr = ps / 2;
+    size = min(4 * ps, AT24Cxx_CAPACITY(type) - addr - 1);
+    check_fill(sdev->mem, AT24Cxx_CAPACITY(type));
+    memset(buf, 0, size);
+    memset(&op, 0, sizeof(op));
+
+    if (AT24Cxx_Async_Read(&op, &dev, addr, buf, size) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Async_Ready(&op, addr, 1) == 0) return CHECK_FAIL;
+    if (AT24Cxx_Async_Ready(&op, addr - 1, 1) == 0 || AT24Cxx_Async_Ready(&op, addr + size, 1) == 0) return CHECK_FAIL;
+
+    /* Wait for the second page, the later pages stay in the background */
+    if (AT24Cxx_Async_Wait(&op, addr + ps, 2) != 0 || AT24Cxx_Async_Ready(&op, addr + ps, 2) != 0) return CHECK_FAIL;
+    if (memcmp(buf + ps, sdev->mem + addr + ps, 2) != 0 || op.state == AT24Cxx_OP_DONE) return CHECK_FAIL;
+    if (AT24Cxx_Async_Wait(&op, addr + size - 1, 2) == 0) return CHECK_FAIL;
+
+    while ((st = AT24Cxx_Async_Poll(&op)) == AT24Cxx_OP_BUSY);
+    if (st != AT24Cxx_OP_DONE || AT24Cxx_Async_Ready(&op, addr, size) != 0) return CHECK_FAIL;
+    if (AT24Cxx_Async_Ready(&op, addr + size, 1) == 0) return CHECK_FAIL;
+
+    return memcmp(buf, sdev->mem + addr, size) == 0 ? CHECK_OK : CHECK_FAIL;
+}
+/**
+ * @brief  The boot region loads with one read and never serves a stale member
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_boot(AT24Cxx_CHIP type)
+{
+    static uint8_t va[4], vb[6], vc[2];
+    static AT24Cxx_VAR_t xa = AT24Cxx_VAR_INIT(0x10, va), xb = AT24Cxx_VAR_INIT(0x1D, vb), xc = AT24Cxx_VAR_INIT(0x30, vc);
+    static AT24Cxx_VAR_t *list[] = { &xa, &xb, &xc };
+    static AT24Cxx_BOOT_t boot = AT24Cxx_BOOT_INIT(0, list);
+    uint8_t next[6];
+    uint16_t i;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    boot.addr = AT24Cxx_CAPACITY(type) / 2;
+    check_fill(sdev->mem, boot.addr);
+
+    /* First boot rebuilds the region, the next one reads it once */
+    if (AT24Cxx_Boot_Load(&dev, &boot) != 0) return CHECK_FAIL;
+    for (i = 0; i < 3; i++) list[i]->state = 0;
+    memset(vb, 0, sizeof(vb));
+    sdev->reads = 0;
+    if (AT24Cxx_Boot_Load(&dev, &boot) != 0 || sdev->reads != 1) return CHECK_FAIL;
+    if (memcmp(vb, sdev->mem + xb.addr, sizeof(vb)) != 0) return CHECK_FAIL;
+
+    /* A member committed on its own */
+    memcpy(next, vb, sizeof(next));
+    next[5] ^= 0xA5;
+    if (AT24Cxx_Var_Set(&dev, &xb, next) != 0 || AT24Cxx_Var_Commit(&dev, &xb) != 0) return CHECK_FAIL;
+    for (i = 0; i < 3; i++) list[i]->state = 0;
+    memset(vb, 0, sizeof(vb));
+    if (AT24Cxx_Boot_Load(&dev, &boot) != 0 || memcmp(vb, next, sizeof(next)) != 0) return CHECK_FAIL;
+
+    /* Rebuilt by the next commit */
+    if (AT24Cxx_Boot_Commit(&dev, &boot) != 0) return CHECK_FAIL;
+    for (i = 0; i < 3; i++) list[i]->state = 0;
+    memset(vb, 0, sizeof(vb));
+    sdev->reads = 0;
+    if (AT24Cxx_Boot_Load(&dev, &boot) != 0 || sdev->reads != 1 || memcmp(vb, next, sizeof(next)) != 0) return CHECK_FAIL;
+
+    return CHECK_OK;
+}
+/**
+ * @brief  Migration from version 0 to 1 for the schema check
+ * @param  {void} *data     : image
+ * @param  {uint16_t} size  : version 0 size
+ * @return {uint16_t}       : version 1 size, 0 --- failed
+ */
+static uint16_t check_migrate(void *data, uint16_t size)
+{
+    uint8_t *p = (uint8_t *)data;
+
+    if (size != 2) return 0;
+    p[2] = p[0] ^ p[1];
+    p[3] = 0x11;
+
+    return 4;
+}
+/**
+ * @brief  An old record migrates in RAM, a failed load never wipes it
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @return {uint8_t}           : CHECK_xxx
+ */
+static uint8_t check_schema(AT24Cxx_CHIP type)
+{
+    static const AT24Cxx_MIGRATE_t migrate[] = { check_migrate };
+    static uint8_t val[4];
+    static AT24Cxx_SCHEMA_t rec = AT24Cxx_SCHEMA_INIT(0x40, val, 1, migrate);
+    static const uint8_t v0[6] = { 0x00, 0xFF, 0x02, 0x00, 0x34, 0x12 };
+    const uint8_t *p;
+    uint8_t next[4] = { 1, 2, 3, 4 };
+    uint32_t p0;
+
+    check_mount(type, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+    if (AT24Cxx_Schema_Get(&dev, &rec) != NULL) return CHECK_FAIL;
+
+    /* Version 0 written by an older firmware */
+    memcpy(sdev->mem + 0x40, v0, sizeof(v0));
+    rec.var.state = 0;
+    p0 = sdev->programs;
+    p = (const uint8_t *)AT24Cxx_Schema_Get(&dev, &rec);
+    if (p == NULL || p[0] != 0x34 || p[1] != 0x12 || p[2] != 0x26 || p[3] != 0x11 || sdev->programs != p0) return CHECK_FAIL;
+
+    /* Bus error while loading */
+    rec.var.state = 0;
+    AT24Cxx_Sim_CutAtByte(1);
+    if (AT24Cxx_Schema_Set(&dev, &rec, next) == 0) return CHECK_FAIL;
+    AT24Cxx_Sim_PowerOn();
+    if (AT24Cxx_Schema_Commit(&dev, &rec) != 0 || memcmp(sdev->mem + 0x40, v0, sizeof(v0)) != 0) return CHECK_FAIL;
+
+    /* Rewritten in the current layout */
+    if (AT24Cxx_Schema_Set(&dev, &rec, next) != 0 || AT24Cxx_Schema_Commit(&dev, &rec) != 0) return CHECK_FAIL;
+    rec.var.state = 0;
+    memset(val, 0, sizeof(val));
+    p = (const uint8_t *)AT24Cxx_Schema_Get(&dev, &rec);
+    if (p == NULL || memcmp(p, next, sizeof(next)) != 0 || rec.stale) return CHECK_FAIL;
+
+    return CHECK_OK;
+}
+/**
+ * @brief Checks
+ */
+static const struct
+{
+    const char *name;
+    uint8_t (*run)(AT24Cxx_CHIP type);
+} checks[] =
+{
+    { "layout",  check_layout },
+    { "var",     check_var },
+    { "async",   check_async },
+    { "cache",   check_cache },
+    { "shadow",  check_shadow },
+    { "lazy",    check_lazy },
+    { "defer",   check_defer },
+    { "txn",     check_txn },
+    { "timeout", check_timeout },
+    { "preload", check_preload },
+    { "boot",    check_boot },
+    { "schema",  check_schema },
+};
+
+int main(int argc, char *argv[])
+{
+    static const char *resname[] = { "ok", "FAIL", "-" };
+    uint32_t first = AT24C01, last = AT24CM02, c, i;
+    AT24Cxx_CHIP type;
+    pid_t pid;
+    int opt, status, res, fail = 0;
+
+    while ((opt = getopt(argc, argv, "c:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': {
+                if (AT24Cxx_Trace_Chip(optarg, &type) != 0)
+                {
+                    fprintf(stderr, "%s: unknown chip\n", optarg);
+                    return 2;
+                }
+                first = last = type;
+                break;}
+            default: {
+                fprintf(stderr, "usage: %s [-c chip]\n", argv[0]);
+                return 2;}
+        }
+    }
+
+    printf("bus : %s\n%-9s", AT24Cxx_I2C_MODE == 0 ? "software (open-drain)" : "hardware", "chip");
+    for (i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) printf(" %8s", checks[i].name);
+    printf("\n");
+
+    for (c = first; c <= last; c++)
+    {
+        printf("%-9s", AT24Cxx_Trace_ChipName[c - 1]);
+
+        for (i = 0; i < sizeof(checks) / sizeof(checks[0]); i++)
+        {
+            fflush(stdout);
+
+            /* Fresh simulated bus and arena per check */
+            pid = fork();
+            if (pid < 0) return 2;
+            if (pid == 0) _exit(checks[i].run((AT24Cxx_CHIP)c));
+
+            res = CHECK_FAIL;
+            if (waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) <= CHECK_NOTBUILT) res = WEXITSTATUS(status);
+            if (res == CHECK_FAIL) fail = 1;
+            printf(" %8s", resname[res]);
+        }
+        printf("\n");
+    }
+
+    return fail;
+}
@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_endurance.c
+ * @brief   Endurance lifetime projection of a workload on the simulated bus
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * The workload (a trace, or a synthetic record rewrite every period) is one pass.
+ * Each layer combination replays one pass to get its simulated time and wear per
+ * page, the time the hottest page exceeds the rated cycles follows from both.
+ * With -x the passes are replayed until a page really fails (or the year limit).
+ * The cache, defer and lazy rows need their driver layers built in, as for
+ * AT24Cxx_replay.
+ *
+ * Build : cc -O2 -I. -IPort/host -IPort -ITools -D'AT24CXX_WCYCLEMS=' Tools/AT24Cxx_endurance.c Tools/AT24Cxx_trace.c Port/AT24Cxx_sim.c AT24Cxx.c -o at24cxx_endurance
+ * All layers : add -DAT24Cxx_CACHE_SETS=16 -DAT24Cxx_DEFER_PAGES=8 -DAT24Cxx_LAZY_WCYCLE=1 -DAT24Cxx_TIMEOUT_MS=20 -DAT24Cxx_TICK_FREQ=1000000 -D'AT24CXX_GETTICK()=AT24Cxx_Sim_Tick()' -include Port/AT24Cxx_sim.h -DAT24Cxx_ARENA_SIZE=65536
+ * Usage : at24cxx_endurance -c AT24C256 [-e cycles] [-m window] [-x] [-y years] <trace | -s size,period_us>
+**/
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#include "AT24Cxx_sim.h"
+#include "AT24Cxx_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+/* Simulated time units */
+#define NS_PER_DAY          (86400.0 * 1e9)
+#define NS_PER_YEAR         (365.25 * NS_PER_DAY)
+
+/**
+ * @brief  Get monotonic time
+ * @return {double} : time (s)
+ */
+static double endurance_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+/**
+ * @brief  Print simulated time
+ * @param  {double} ns : time (ns)
+ * @return none
+ */
+static void endurance_print(double ns)
+{
+    if (ns >= NS_PER_YEAR) printf(" %10.2f y", ns / NS_PER_YEAR);
+    else if (ns >= NS_PER_DAY) printf(" %10.2f d", ns / NS_PER_DAY);
+    else printf(" %10.2f s", ns / 1e9);
+}
+int main(int argc, char *argv[])
+{
+    AT24Cxx_CHIP type = AT24C02;
+    uint32_t bus_hz = 400000, twr_us = 3500, window = 256, endurance = 1000000;
+    uint32_t num = 0, cap, p, hot, size = 0, period = 0, hits, misses;
+    double years = 100, t0, passtime, life;
+    AT24Cxx_TRACE_t *ops = NULL;
+    AT24Cxx_LAYER_t layer;
+    AT24Cxx_SIM_DEV_t *sdev;
+    at24cxx_t dev;
+    uint8_t *img, full = 0;
+    int i, opt, run, fail = 0;
+
+    while ((opt = getopt(argc, argv, "c:f:t:m:e:xy:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': if (AT24Cxx_Trace_Chip(optarg, &type) != 0) { fprintf(stderr, "%s: unknown chip\n", optarg); return 2; } break;
+            case 'f': bus_hz = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 't': twr_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'm': window = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'e': endurance = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'x': full = 1; break;
+            case 'y': years = strtod(optarg, NULL); break;
+            case 's': if (sscanf(optarg, "%u,%u", &size, &period) != 2) size = 0; break;
+            default: break;
+        }
+    }
+
+    if (size != 0)
+    {
+        /* Synthetic workload : one record rewritten every period */
+        ops = (AT24Cxx_TRACE_t *)calloc(2, sizeof(AT24Cxx_TRACE_t));
+        ops[0].op = 'W';
+        ops[0].size = size;
+        ops[1].op = 'D';
+        ops[1].arg = period;
+        num = 2;
+    }
+    else if (optind >= argc || AT24Cxx_Trace_Load(argv[optind], &ops, &num) != 0)
+    {
+        fprintf(stderr, "usage: %s -c <chip> [-f bus_hz] [-t twr_us] [-m window] [-e cycles] [-x] [-y years] <trace | -s size,period_us>\n", argv[0]);
+        return 2;
+    }
+    if (bus_hz == 0 || endurance == 0) return 2;
+
+    cap = AT24Cxx_CAPACITY(type);
+    img = (uint8_t *)malloc(cap);
+
+    printf("%s, %u ops per pass, %u Hz, tWR %u us, %u cycles per page, coalescing window %u\n",
+           AT24Cxx_Trace_ChipName[type - 1], num, bus_hz, twr_us, endurance, window);
+    printf("%-17s %12s %9s %6s %12s %9s %9s%s\n", "layers", "pass", "hotwear", "page", "projected", "hits", "misses", full ? "    simulated  programs/s" : "");
+
+    for (run = 0; run < AT24Cxx_TRACE_RUNS; run++)
+    {
+        AT24Cxx_Sim_Init(bus_hz, twr_us, AT24Cxx_Trace_Runs[run].wait);
+        AT24Cxx_Sim.endurance = endurance;
+        sdev = AT24Cxx_Sim_Attach(type, 0);
+
+        memset(&dev, 0, sizeof(dev));
+        dev.port.bus = AT24Cxx_SIM_PORT;
+        AT24Cxx_config(&dev, type, 0x0A, 0);
+
+        layer = AT24Cxx_Trace_Runs[run].layer;
+        if (layer.coalesce) layer.coalesce = window;
+
+        i = AT24Cxx_Trace_Attach(&dev, &layer);
+        if (i != 0)
+        {
+            printf("%-17s %12s\n", AT24Cxx_Trace_Runs[run].name, i == 2 ? "not built" : "arena");
+            if (i != 2) fail = 1;
+            continue;
+        }
+        memset(img, 0xFF, cap);
+
+        /* One pass gives the time and the wear per pass */
+        if (AT24Cxx_Trace_Replay(&dev, ops, num, &layer, img, AT24Cxx_Sim_Idle) != 0) fail = 1;
+        passtime = (double)AT24Cxx_Sim.now;
+
+        hot = 0;
+        for (p = 1; p < AT24Cxx_Sim_Pages(sdev); p++)
+        {
+            if (sdev->wear[p] > sdev->wear[hot]) hot = p;
+        }
+
+        printf("%-17s", AT24Cxx_Trace_Runs[run].name);
+        endurance_print(passtime);
+        printf(" %9u %6u", sdev->wear[hot], hot);
+
+        if (sdev->wear[hot] == 0)
+        {
+            printf(" %12s", "never");
+        }
+        else
+        {
+            life = ((double)endurance + 1) / sdev->wear[hot] * passtime;
+            printf("  ");
+            endurance_print(life);
+        }
+
+        hits = misses = 0;
+#if AT24Cxx_CACHE_SETS != 0
+        if (dev.cache != NULL) AT24Cxx_Cache_Stats(&dev, &hits, &misses);
+#endif
+        printf(" %9u %9u", hits, misses);
+
+        if (full)
+        {
+            t0 = endurance_now();
+            while (sdev->failpage == AT24Cxx_SIM_NOFAIL && sdev->wear[hot] != 0 && AT24Cxx_Sim.now < years * NS_PER_YEAR)
+            {
+                AT24Cxx_Trace_Replay(&dev, ops, num, &layer, img, AT24Cxx_Sim_Idle);
+            }
+            t0 = endurance_now() - t0;
+
+            if (sdev->failpage == AT24Cxx_SIM_NOFAIL) printf(" %12s", ">limit");
+            else endurance_print((double)sdev->failtime);
+            printf(" %11.0f", t0 > 0 ? sdev->programs / t0 : 0);
+        }
+
+        printf("\n");
+    }
+
+    AT24Cxx_Sim_Init(bus_hz, twr_us, AT24Cxx_SIM_WAIT_FIXED);
+    free(img);
+    free(ops);
+
+    return fail;
+}
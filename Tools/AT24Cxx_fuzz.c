@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_fuzz.c
+ * @brief   Differential fuzzing of the driver against a flat memory image
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * Random AT24Cxx_Read, AT24Cxx_Write, AT24Cxx_Erase and AT24Cxx_Readback_Write
+ * calls (any address, sizes up to the whole chip) run on the simulated bus and on
+ * a flat array. Every read is compared with the array, the simulated memory is
+ * compared with it at the end. Every driver layer combination of the what-if tools
+ * runs (the coalescing rows are a trace feature and skipped), rows whose layers are
+ * not built in are reported as such. The simulated bus is a single global, so each
+ * chip type runs in its own process, all chip types in parallel.
+ *
+ * Build : cc -O2 -I. -IPort/host -IPort -ITools -D'AT24CXX_WCYCLEMS=' Tools/AT24Cxx_fuzz.c Tools/AT24Cxx_trace.c Port/AT24Cxx_sim.c AT24Cxx.c -o at24cxx_fuzz
+ * All layers : add -DAT24Cxx_CACHE_SETS=16 -DAT24Cxx_DEFER_PAGES=8 -DAT24Cxx_LAZY_WCYCLE=1 -DAT24Cxx_TIMEOUT_MS=20 -DAT24Cxx_TICK_FREQ=1000000 -D'AT24CXX_GETTICK()=AT24Cxx_Sim_Tick()' -include Port/AT24Cxx_sim.h -DAT24Cxx_ARENA_SIZE=65536
+ * Software bus : add -DAT24Cxx_I2C_MODE=0 -DAT24Cxx_SW_OPENDRAIN=1
+ * Usage : at24cxx_fuzz [-c chip] [-n ops] [-s seed]
+**/
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#include "AT24Cxx_trace.h"
+#include "AT24Cxx_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Result of one chip, sent from the worker process
+ */
+typedef struct
+{
+    uint32_t ops;                   /* calls done */
+    uint32_t fail;                  /* 0 --- ok, 1 --- call failed, 2 --- read differs, 3 --- memory differs, 4 --- not built, 5 --- arena */
+    char op;                        /* failing call */
+    uint32_t addr;                  /* failing call address (memory : first differing byte) */
+    uint32_t size;                  /* failing call size */
+    uint64_t transfers;             /* bus transfers */
+    uint64_t bytes;                 /* bus bytes */
+    uint32_t programs;              /* page programs */
+    uint32_t reads;                 /* read transfers */
+} FUZZ_RESULT_t;
+
+/**
+ * @brief  Random number (xorshift64)
+ * @param  {uint64_t} *x : state
+ * @return {uint32_t}    : random number
+ */
+static uint32_t fuzz_rand(uint64_t *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+
+    return (uint32_t)(*x >> 32);
+}
+/**
+ * @brief  Fuzz one chip type with one layer combination
+ * @param  {AT24Cxx_CHIP} type : chip type
+ * @param  {const AT24Cxx_RUN_t} *run : layer combination
+ * @param  {uint32_t} num      : number of calls
+ * @param  {uint64_t} seed     : random seed
+ * @param  {FUZZ_RESULT_t} *res : result
+ * @return none
+ * @note   Most sizes stay within a few pages, one call in eight may span the chip
+ */
+static void fuzz_chip(AT24Cxx_CHIP type, const AT24Cxx_RUN_t *run, uint32_t num, uint64_t seed, FUZZ_RESULT_t *res)
+{
+    static const char opname[] = { 'R', 'W', 'E', 'B' };
+    uint32_t cap = AT24Cxx_CAPACITY(type);
+    uint8_t *ref = (uint8_t *)malloc(cap);
+    uint8_t *buf = (uint8_t *)malloc(cap);
+    uint32_t i, j, addr, size, span;
+    uint64_t x = seed * 0x9E3779B97F4A7C15ULL + type;
+    AT24Cxx_SIM_DEV_t *sdev;
+    at24cxx_t dev;
+    uint8_t rsp = 0, fdata;
+    char op;
+
+    AT24Cxx_Sim_Init(1000000, 3500, run->wait);
+    sdev = AT24Cxx_Sim_Attach(type, 0);
+
+    memset(&dev, 0, sizeof(dev));
+    dev.port.bus = AT24Cxx_SIM_PORT;
+    AT24Cxx_config(&dev, type, 0x0A, 0);
+
+    memset(res, 0, sizeof(FUZZ_RESULT_t));
+    memset(ref, 0xFF, cap);
+
+    switch (AT24Cxx_Trace_Attach(&dev, &run->layer))
+    {
+        case 0: break;
+        case 2: res->fail = 4; break;
+        default: res->fail = 5; break;
+    }
+    if (res->fail != 0)
+    {
+        free(ref);
+        free(buf);
+        return;
+    }
+
+    for (i = 0; i < num && res->fail == 0; i++)
+    {
+        op = opname[fuzz_rand(&x) % 4];
+        addr = fuzz_rand(&x) % cap;
+        span = cap - addr;
+        if (fuzz_rand(&x) % 8 != 0 && span > 4 * (uint32_t)dev.info.pagesize) span = 4 * dev.info.pagesize;
+        size = fuzz_rand(&x) % (span + 1);
+
+        switch (op)
+        {
+            case 'R': {
+                rsp = AT24Cxx_Read(&dev, addr, buf, size);
+                if (rsp == 0 && memcmp(buf, ref + addr, size) != 0) res->fail = 2;
+                break;}
+            case 'W':
+            case 'B': {
+                for (j = 0; j < size; j++) buf[j] = (uint8_t)fuzz_rand(&x);
+                rsp = (op == 'W') ? AT24Cxx_Write(&dev, addr, buf, size) : AT24Cxx_Readback_Write(&dev, addr, buf, size);
+                memcpy(ref + addr, buf, size);
+                break;}
+            case 'E': {
+                fdata = (uint8_t)fuzz_rand(&x);
+                rsp = AT24Cxx_Erase(&dev, addr, fdata, size);
+                memset(ref + addr, fdata, size);
+                break;}
+            default: break;
+        }
+
+        if (rsp != 0) res->fail = 1;
+        res->op = op;
+        res->addr = addr;
+        res->size = size;
+        res->ops++;
+    }
+
+    /* Final memory image, staged pages and the last write cycle programmed */
+    if (res->fail == 0 && AT24Cxx_Trace_Sync(&dev) != 0) res->fail = 1;
+    if (res->fail == 0)
+    {
+        for (j = 0; j < cap && sdev->mem[j] == ref[j]; j++);
+        if (j < cap)
+        {
+            res->fail = 3;
+            res->addr = j;
+        }
+    }
+
+    res->transfers = AT24Cxx_Sim.transfers;
+    res->bytes = AT24Cxx_Sim.bytes;
+    res->programs = sdev->programs;
+    res->reads = sdev->reads;
+
+    free(ref);
+    free(buf);
+}
+int main(int argc, char *argv[])
+{
+    static const char *failname[] = { "ok", "call failed", "read differs", "memory differs", "not built", "arena" };
+    uint32_t num = 20000, first = AT24C01, last = AT24CM02, c, i, r;
+    AT24Cxx_CHIP type;
+    uint64_t seed = 1;
+    FUZZ_RESULT_t res[12][AT24Cxx_TRACE_RUNS];
+    int fd[12][2];
+    pid_t pid[12];
+    int opt, status, bad = 0;
+
+    while ((opt = getopt(argc, argv, "c:n:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': {
+                if (AT24Cxx_Trace_Chip(optarg, &type) != 0)
+                {
+                    fprintf(stderr, "%s: unknown chip\n", optarg);
+                    return 2;
+                }
+                first = last = type;
+                break;}
+            case 'n': num = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': seed = strtoull(optarg, NULL, 0); break;
+            default: {
+                fprintf(stderr, "usage: %s [-c chip] [-n ops] [-s seed]\n", argv[0]);
+                return 2;}
+        }
+    }
+
+    /* One worker process per chip type */
+    for (c = first; c <= last; c++)
+    {
+        i = c - AT24C01;
+        if (pipe(fd[i]) != 0) return 2;
+
+        pid[i] = fork();
+        if (pid[i] < 0) return 2;
+        if (pid[i] == 0)
+        {
+            close(fd[i][0]);
+            for (r = 0; r < AT24Cxx_TRACE_RUNS; r++)
+            {
+                if (AT24Cxx_Trace_Runs[r].layer.coalesce == 0) fuzz_chip((AT24Cxx_CHIP)c, &AT24Cxx_Trace_Runs[r], num, seed, &res[i][r]);
+            }
+            _exit(write(fd[i][1], res[i], sizeof(res[i])) == (ssize_t)sizeof(res[i]) ? 0 : 1);
+        }
+        close(fd[i][1]);
+    }
+
+    printf("%u calls per chip, seed %llu\n", num, (unsigned long long)seed);
+    printf("%-9s %-17s %8s %10s %12s %10s %10s  %s\n", "chip", "layers", "calls", "transfers", "bytes", "programs", "reads", "result");
+
+    for (c = first; c <= last; c++)
+    {
+        i = c - AT24C01;
+        if (read(fd[i][0], res[i], sizeof(res[i])) != (ssize_t)sizeof(res[i]))
+        {
+            memset(res[i], 0, sizeof(res[i]));
+            for (r = 0; r < AT24Cxx_TRACE_RUNS; r++)
+            {
+                res[i][r].fail = 1;
+                res[i][r].op = '?';
+            }
+        }
+        close(fd[i][0]);
+        waitpid(pid[i], &status, 0);
+
+        for (r = 0; r < AT24Cxx_TRACE_RUNS; r++)
+        {
+            if (AT24Cxx_Trace_Runs[r].layer.coalesce != 0) continue;
+
+            printf("%-9s %-17s %8u %10llu %12llu %10u %10u  %s", AT24Cxx_Trace_ChipName[i], AT24Cxx_Trace_Runs[r].name, res[i][r].ops,
+                   (unsigned long long)res[i][r].transfers, (unsigned long long)res[i][r].bytes,
+                   res[i][r].programs, res[i][r].reads, failname[res[i][r].fail]);
+            if (res[i][r].fail == 3) printf(" at 0x%05X", res[i][r].addr);
+            else if (res[i][r].fail <= 2 && res[i][r].fail != 0) printf(" (%c 0x%05X %u)", res[i][r].op, res[i][r].addr, res[i][r].size);
+            printf("\n");
+
+            if (res[i][r].fail != 0 && res[i][r].fail != 4) bad = 1;
+        }
+    }
+
+    return bad;
+}
@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_gang.c
+ * @brief   Host gang programmer, one worker thread per Linux i2c-dev adapter
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * Build : cc -O2 -I. -IPort/host -IPort -ITools -D'AT24CXX_WCYCLEMS=' Tools/AT24Cxx_gang.c Tools/AT24Cxx_trace.c Port/AT24Cxx_i2cdev.c AT24Cxx.c -lpthread -o at24cxx_gang
+ * Usage : at24cxx_gang -c AT24C256 [-a hardaddr] [-o offset] -i image.bin /dev/i2c-1 /dev/i2c-2 ...
+**/
+
+#define _DEFAULT_SOURCE
+#include "AT24Cxx_i2cdev.h"
+#include "AT24Cxx_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+/* Verify read chunk size */
+#define GANG_VERIFY_SIZE    4096
+
+/**
+ * @brief Gang worker (one per adapter)
+ */
+typedef struct
+{
+    const char *path;
+    pthread_t thread;
+    at24cxx_t dev;
+    int fd;
+    uint8_t rsp;                    /* 0 : pass, 1 : bus error, 2 : verify error */
+    double wtime;                   /* write time (s) */
+    double vtime;                   /* verify time (s) */
+} gang_worker_t;
+
+/* Shared image */
+static uint8_t *image;
+static uint32_t image_size;
+static uint32_t image_addr;
+
+/**
+ * @brief  Get monotonic time
+ * @return {double} : time (s)
+ */
+static double gang_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+/**
+ * @brief  Program and verify one adapter
+ * @param  {void} *arg : gang worker
+ * @return {void *}    : NULL
+ * @note   Write cycles of different adapters overlap, each worker sleeps in
+ *         its own acknowledge polling.
+ */
+static void *gang_work(void *arg)
+{
+    gang_worker_t *w = (gang_worker_t *)arg;
+    uint8_t buf[GANG_VERIFY_SIZE];
+    uint32_t i, len;
+    double t0;
+
+    AT24Cxx_I2cdev_Bind(w->fd);
+
+    /* Program */
+    t0 = gang_now();
+    w->rsp = AT24Cxx_Write(&w->dev, image_addr, image, image_size);
+    w->wtime = gang_now() - t0;
+
+    /* Verify */
+    t0 = gang_now();
+    for (i = 0; i < image_size && w->rsp == 0; i += len)
+    {
+        len = image_size - i;
+        if (len > GANG_VERIFY_SIZE) len = GANG_VERIFY_SIZE;
+
+        if (AT24Cxx_Read(&w->dev, image_addr + i, buf, len))
+        {
+            w->rsp = 1;
+        }
+        else if (memcmp(buf, image + i, len) != 0)
+        {
+            w->rsp = 2;
+        }
+    }
+    w->vtime = gang_now() - t0;
+
+    return NULL;
+}
+/**
+ * @brief  Load image file
+ * @param  {const char} *path : image path
+ * @return {int}              : 0 --- success, -1 --- error
+ */
+static int gang_load(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    long size;
+
+    if (fp == NULL) return -1;
+
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) != 0)
+    {
+        fclose(fp);
+        return -1;
+    }
+
+    image = (uint8_t *)malloc(size > 0 ? size : 1);
+    image_size = (uint32_t)size;
+    if (image == NULL || fread(image, 1, image_size, fp) != image_size)
+    {
+        fclose(fp);
+        return -1;
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+int main(int argc, char *argv[])
+{
+    gang_worker_t *workers;
+    AT24Cxx_CHIP type = AT24C02;
+    uint8_t hardaddr = 0;
+    const char *path = NULL;
+    int i, n, opt, fail = 0;
+    double t0;
+
+    while ((opt = getopt(argc, argv, "c:a:o:i:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': if (AT24Cxx_Trace_Chip(optarg, &type) != 0) { fprintf(stderr, "%s: unknown chip\n", optarg); return 2; } break;
+            case 'a': hardaddr = (uint8_t)strtoul(optarg, NULL, 0); break;
+            case 'o': image_addr = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'i': path = optarg; break;
+            default: break;
+        }
+    }
+
+    n = argc - optind;
+    if (path == NULL || n <= 0)
+    {
+        fprintf(stderr, "usage: %s -c <chip> [-a hardaddr] [-o offset] -i <image> /dev/i2c-N ...\n", argv[0]);
+        return 2;
+    }
+
+    if (gang_load(path) != 0 || image_addr + image_size > AT24Cxx_CAPACITY(type))
+    {
+        fprintf(stderr, "%s: cannot load or does not fit %s\n", path, AT24Cxx_Trace_ChipName[type - 1]);
+        return 2;
+    }
+
+    /* Mount devices before starting workers, AT24Cxx_config is not thread safe */
+    workers = (gang_worker_t *)calloc(n, sizeof(gang_worker_t));
+    for (i = 0; i < n; i++)
+    {
+        workers[i].path = argv[optind + i];
+        workers[i].fd = AT24Cxx_I2cdev_Open(workers[i].path);
+        workers[i].dev.port.bus = &AT24Cxx_I2cdev_Bus;
+        AT24Cxx_config(&workers[i].dev, type, 0x0A, hardaddr);
+    }
+
+    t0 = gang_now();
+    for (i = 0; i < n; i++)
+    {
+        if (workers[i].fd < 0)
+        {
+            workers[i].rsp = 1;
+            continue;
+        }
+        pthread_create(&workers[i].thread, NULL, gang_work, &workers[i]);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        if (workers[i].fd >= 0) pthread_join(workers[i].thread, NULL);
+    }
+
+    /* Report */
+    printf("%-16s %-8s %10s %10s\n", "adapter", "result", "write(s)", "verify(s)");
+    for (i = 0; i < n; i++)
+    {
+        printf("%-16s %-8s %10.3f %10.3f\n", workers[i].path,
+               workers[i].rsp == 0 ? "PASS" : (workers[i].rsp == 1 ? "BUS" : "VERIFY"),
+               workers[i].wtime, workers[i].vtime);
+        fail += (workers[i].rsp != 0);
+        if (workers[i].fd >= 0) AT24Cxx_I2cdev_Close(workers[i].fd);
+    }
+    printf("%d/%d passed, %u bytes each, total %.3f s\n", n - fail, n, image_size, gang_now() - t0);
+
+    free(workers);
+    free(image);
+
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_powercut.c
+ * @brief   Power-loss sweep of the driver on the simulated bus
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * An unaligned AT24Cxx_Write and AT24Cxx_Erase over several pages is cut at every
+ * bus byte (AT24Cxx_Sim_CutAtByte) and in the write cycle of every page program
+ * (AT24Cxx_Sim_CutAtProgram, nothing, half or all of the page kept). After power on
+ * the call range must hold new data followed by old data : the whole programs before
+ * the cut, the kept bytes of a cut write cycle and nothing else, never beyond a page,
+ * and nothing outside the call changes. The driver must then write and read the range
+ * again. The software bus build cuts the modelled SCL and SDA lines.
+ *
+ * Build : cc -O2 -I. -IPort/host -IPort -ITools -D'AT24CXX_WCYCLEMS=' Tools/AT24Cxx_powercut.c Tools/AT24Cxx_trace.c Port/AT24Cxx_sim.c AT24Cxx.c -o at24cxx_powercut
+ * Software bus : add -DAT24Cxx_I2C_MODE=0 -DAT24Cxx_SW_OPENDRAIN=1
+ * Usage : at24cxx_powercut [-c chip] [-n pages]
+**/
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#include "AT24Cxx_sim.h"
+#include "AT24Cxx_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+/* Tool Function */
+#define min(a, b)           (((a) < (b)) ? (a) : (b))       /* Take the minimum value */
+
+/**
+ * @brief Swept call
+ */
+typedef struct
+{
+    at24cxx_t dev;
+    AT24Cxx_SIM_DEV_t *sdev;
+    char op;                        /* 'W' : AT24Cxx_Write, 'E' : AT24Cxx_Erase */
+    uint32_t addr;                  /* call address */
+    uint32_t size;                  /* call size */
+    uint32_t base;                  /* checked window, whole pages around the call */
+    uint32_t end;
+    uint8_t *old;                   /* memory before the call */
+    uint8_t *new;                   /* call data (absolute addresses) */
+    uint8_t *buf;
+} CUT_CALL_t;
+
+/**
+ * @brief  Get monotonic time
+ * @return {double} : time (s)
+ */
+static double powercut_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+/**
+ * @brief  Restore the old memory and run the call
+ * @param  {CUT_CALL_t} *call : call
+ * @return {uint8_t}          : driver return
+ */
+static uint8_t powercut_run(CUT_CALL_t *call)
+{
+    memcpy(call->sdev->mem + call->base, call->old + call->base, call->end - call->base);
+
+    if (call->op == 'W') return AT24Cxx_Write(&call->dev, call->addr, call->new + call->addr, call->size);
+
+    return AT24Cxx_Erase(&call->dev, call->addr, call->new[call->addr], call->size);
+}
+/**
+ * @brief  Check memory after a cut
+ * @param  {CUT_CALL_t} *call : call
+ * @param  {uint32_t} *done   : bytes of the call holding new data
+ * @return {uint8_t}          : 0 --- new data up to done, old data behind it
+ *                              1 --- torn, out of order or outside the call
+ */
+static uint8_t powercut_check(CUT_CALL_t *call, uint32_t *done)
+{
+    uint32_t i, n;
+
+    for (n = 0; n < call->size && call->sdev->mem[call->addr + n] == call->new[call->addr + n]; n++);
+    *done = n;
+
+    for (i = call->base; i < call->end; i++)
+    {
+        if ((i < call->addr || i >= call->addr + n) && call->sdev->mem[i] != call->old[i]) return 1;
+    }
+
+    return 0;
+}
+/**
+ * @brief  Power on and check that the driver writes and reads the call range
+ * @param  {CUT_CALL_t} *call : call
+ * @return {uint8_t}          : 0 --- recovered
+ *                              1 --- failed
+ */
+static uint8_t powercut_recover(CUT_CALL_t *call)
+{
+    AT24Cxx_Sim_PowerOn();
+
+    if (AT24Cxx_Write(&call->dev, call->addr, call->new + call->addr, call->size) != 0) return 1;
+    if (AT24Cxx_Read(&call->dev, call->addr, call->buf, call->size) != 0) return 1;
+
+    return memcmp(call->buf, call->new + call->addr, call->size) != 0;
+}
+int main(int argc, char *argv[])
+{
+    static const char *cutname[] = { "program", "program/2", "program/0", "byte" };
+    uint32_t first = AT24C01, last = AT24CM02, pages = 4, c, cap, bytes, programs, n, cuts, bad, keep, done, k;
+    uint32_t *bound;
+    AT24Cxx_CHIP type;
+    CUT_CALL_t call;
+    double t0;
+    int opt, o, kind, fail = 0;
+
+    while ((opt = getopt(argc, argv, "c:n:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': {
+                if (AT24Cxx_Trace_Chip(optarg, &type) != 0)
+                {
+                    fprintf(stderr, "%s: unknown chip\n", optarg);
+                    return 2;
+                }
+                first = last = type;
+                break;}
+            case 'n': pages = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default: {
+                fprintf(stderr, "usage: %s [-c chip] [-n pages]\n", argv[0]);
+                return 2;}
+        }
+    }
+    if (pages == 0) return 2;
+
+    printf("bus : %s, %u pages per call\n", AT24Cxx_I2C_MODE == 0 ? "software (open-drain)" : "hardware", pages);
+    printf("%-9s %-2s %-10s %8s %8s %12s  %s\n", "chip", "op", "cut", "cuts", "bad", "cuts/s", "result");
+
+    for (c = first; c <= last; c++)
+    {
+        AT24Cxx_Sim_Init(1000000, 3500, AT24Cxx_SIM_WAIT_ACKPOLL);
+        call.sdev = AT24Cxx_Sim_Attach((AT24Cxx_CHIP)c, 0);
+
+        memset(&call.dev, 0, sizeof(call.dev));
+        call.dev.port.bus = AT24Cxx_SIM_PORT;
+        AT24Cxx_config(&call.dev, (AT24Cxx_CHIP)c, 0x0A, 0);
+
+        /* Unaligned call, partial first and last page */
+        cap = AT24Cxx_CAPACITY(c);
+        call.addr = call.dev.info.pagesize / 2;
+        call.size = min(pages * call.dev.info.pagesize, cap - call.addr);
+        call.base = 0;
+        call.end = min(call.addr + call.size + call.dev.info.pagesize, cap);
+        call.end -= call.end % call.dev.info.pagesize;
+        call.old = (uint8_t *)malloc(cap);
+        call.new = (uint8_t *)malloc(cap);
+        call.buf = (uint8_t *)malloc(cap);
+
+        for (o = 0; o < 2; o++)
+        {
+            call.op = o == 0 ? 'W' : 'E';
+            for (k = 0; k < call.end; k++)
+            {
+                call.old[k] = (uint8_t)(k * 7 + 3) | 0x80;          /* never equal to the new data */
+                call.new[k] = (o == 0) ? (uint8_t)(call.old[k] ^ 0xA5) : 0x5A;
+            }
+
+            /* Uncut call gives the bus bytes and the page programs to sweep */
+            AT24Cxx_Sim_PowerOn();
+            bytes = (uint32_t)AT24Cxx_Sim.bytes;
+            programs = call.sdev->programs;
+            if (powercut_run(&call) != 0) fail = 1;
+            bytes = (uint32_t)AT24Cxx_Sim.bytes - bytes;
+            programs = call.sdev->programs - programs;
+            bound = (uint32_t *)calloc(programs + 1, sizeof(uint32_t));
+
+            for (kind = 0; kind < 4; kind++)
+            {
+                n = (kind == 3) ? bytes : programs;
+                keep = (kind == 0) ? 0xFFFFFFFFUL : (kind == 1) ? call.dev.info.pagesize / 2U : 0;
+                bad = 0;
+                t0 = powercut_now();
+
+                for (cuts = 1; cuts <= n; cuts++)
+                {
+                    AT24Cxx_Sim_PowerOn();
+                    if (kind == 3) AT24Cxx_Sim_CutAtByte(cuts);
+                    else AT24Cxx_Sim_CutAtProgram(cuts, keep);
+
+                    /* A cut before the last write cycle fails the call */
+                    if ((powercut_run(&call) == 0 && (kind == 3 || cuts < n)) || powercut_check(&call, &done) != 0)
+                    {
+                        bad++;
+                        continue;
+                    }
+
+                    if (kind == 0)
+                    {
+                        /* Whole programs give the program boundaries, in order and within a page */
+                        bound[cuts] = done;
+                        if (done <= bound[cuts - 1] || (call.addr + bound[cuts - 1]) / call.dev.info.pagesize != (call.addr + done - 1) / call.dev.info.pagesize) bad++;
+                    }
+                    else if (kind == 3)
+                    {
+                        /* A program never starts before its STOP condition, memory ends at a program boundary */
+                        for (k = 0; k <= programs && bound[k] != done; k++);
+                        if (k > programs) bad++;
+                    }
+                    else if (done != bound[cuts - 1] + min(keep, bound[cuts] - bound[cuts - 1]))
+                    {
+                        bad++;
+                    }
+
+                    if (powercut_recover(&call) != 0) bad++;
+                }
+
+                t0 = powercut_now() - t0;
+                printf("%-9s %-2c %-10s %8u %8u %12.0f  %s\n", AT24Cxx_Trace_ChipName[c - 1], call.op, cutname[kind],
+                       n, bad, t0 > 0 ? n / t0 : 0, bad == 0 ? "ok" : "FAIL");
+                if (bad != 0) fail = 1;
+            }
+
+            if (bound[programs] != call.size) fail = 1;
+            free(bound);
+        }
+
+        free(call.old);
+        free(call.new);
+        free(call.buf);
+    }
+
+    AT24Cxx_Sim_PowerOn();
+
+    return fail;
+}
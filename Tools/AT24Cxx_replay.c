@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_replay.c
+ * @brief   Workload trace replay on the simulated bus, what-if table of layers
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * Every layer combination replays the same trace from an erased device and reports
+ * simulated bus time, transfers, write cycles, page wear and cache hits. The cache,
+ * defer and lazy rows need their driver layers built in (AT24Cxx_CACHE_SETS,
+ * AT24Cxx_DEFER_PAGES, AT24Cxx_LAZY_WCYCLE with AT24Cxx_TIMEOUT_MS) and an arena
+ * for all rows, they are reported as not built otherwise.
+ *
+ * Build : cc -O2 -I. -IPort/host -IPort -ITools -D'AT24CXX_WCYCLEMS=' Tools/AT24Cxx_replay.c Tools/AT24Cxx_trace.c Port/AT24Cxx_sim.c AT24Cxx.c -o at24cxx_replay
+ * All layers : add -DAT24Cxx_CACHE_SETS=16 -DAT24Cxx_DEFER_PAGES=8 -DAT24Cxx_LAZY_WCYCLE=1 -DAT24Cxx_TIMEOUT_MS=20 -DAT24Cxx_TICK_FREQ=1000000 -D'AT24CXX_GETTICK()=AT24Cxx_Sim_Tick()' -include Port/AT24Cxx_sim.h -DAT24Cxx_ARENA_SIZE=65536
+ * Usage : at24cxx_replay -c AT24C256 [-f bus_hz] [-t twr_us] [-m window] trace.txt
+**/
+
+#include "AT24Cxx_sim.h"
+#include "AT24Cxx_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+int main(int argc, char *argv[])
+{
+    AT24Cxx_CHIP type = AT24C02;
+    uint32_t bus_hz = 400000, twr_us = 3500, window = 256;
+    AT24Cxx_TRACE_t *ops;
+    AT24Cxx_LAYER_t layer;
+    AT24Cxx_SIM_DEV_t *sdev;
+    at24cxx_t dev;
+    uint8_t *img;
+    uint32_t num, cap, p, maxwear, touched, hits, misses;
+    int i, opt, run, fail = 0;
+
+    while ((opt = getopt(argc, argv, "c:f:t:m:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': if (AT24Cxx_Trace_Chip(optarg, &type) != 0) { fprintf(stderr, "%s: unknown chip\n", optarg); return 2; } break;
+            case 'f': bus_hz = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 't': twr_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'm': window = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default: break;
+        }
+    }
+
+    if (optind >= argc || bus_hz == 0)
+    {
+        fprintf(stderr, "usage: %s -c <chip> [-f bus_hz] [-t twr_us] [-m window] <trace|->\n", argv[0]);
+        return 2;
+    }
+    if (AT24Cxx_Trace_Load(argv[optind], &ops, &num) != 0) return 2;
+
+    cap = AT24Cxx_CAPACITY(type);
+    img = (uint8_t *)malloc(cap);
+
+    printf("%s, %u ops, %u Hz, tWR %u us, coalescing window %u\n", AT24Cxx_Trace_ChipName[type - 1], num, bus_hz, twr_us, window);
+    printf("%-17s %12s %9s %9s %10s %7s %8s %8s %9s %9s %6s\n", "layers", "time(ms)", "reads", "programs", "written", "nacks", "maxwear", "pages", "hits", "misses", "check");
+
+    for (run = 0; run < AT24Cxx_TRACE_RUNS; run++)
+    {
+        AT24Cxx_Sim_Init(bus_hz, twr_us, AT24Cxx_Trace_Runs[run].wait);
+        sdev = AT24Cxx_Sim_Attach(type, 0);
+
+        memset(&dev, 0, sizeof(dev));
+        dev.port.bus = AT24Cxx_SIM_PORT;
+        AT24Cxx_config(&dev, type, 0x0A, 0);
+
+        layer = AT24Cxx_Trace_Runs[run].layer;
+        if (layer.coalesce) layer.coalesce = window;
+
+        i = AT24Cxx_Trace_Attach(&dev, &layer);
+        if (i == 2)
+        {
+            printf("%-17s %12s\n", AT24Cxx_Trace_Runs[run].name, "not built");
+            continue;
+        }
+        if (i != 0)
+        {
+            printf("%-17s %12s\n", AT24Cxx_Trace_Runs[run].name, "arena");
+            fail = 1;
+            continue;
+        }
+        memset(img, 0xFF, cap);
+
+        if (AT24Cxx_Trace_Replay(&dev, ops, num, &layer, img, AT24Cxx_Sim_Idle) != 0) fail = 1;
+
+        maxwear = touched = 0;
+        for (p = 0; p < AT24Cxx_Sim_Pages(sdev); p++)
+        {
+            if (sdev->wear[p] > maxwear) maxwear = sdev->wear[p];
+            if (sdev->wear[p] != 0) touched++;
+        }
+
+        hits = misses = 0;
+#if AT24Cxx_CACHE_SETS != 0
+        if (dev.cache != NULL) AT24Cxx_Cache_Stats(&dev, &hits, &misses);
+#endif
+
+        i = memcmp(sdev->mem, img, cap) == 0;
+        if (!i) fail = 1;
+
+        printf("%-17s %12.3f %9u %9u %10llu %7u %8u %8u %9u %9u %6s\n",
+               AT24Cxx_Trace_Runs[run].name, AT24Cxx_Sim.now / 1e6, sdev->reads, sdev->programs, (unsigned long long)sdev->wbytes,
+               sdev->nacks, maxwear, touched, hits, misses, i ? "ok" : "FAIL");
+    }
+
+    AT24Cxx_Sim_Init(bus_hz, twr_us, AT24Cxx_SIM_WAIT_FIXED);
+    free(img);
+    free(ops);
+
+    return fail;
+}
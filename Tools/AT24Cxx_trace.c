@@ -0,0 +1,326 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_trace.c
+ * @brief   Workload trace parser and replay, shared tool tables source file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+**/
+
+#include "AT24Cxx_trace.h"
+#include "AT24Cxx_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/* Tool Function */
+#define min(a, b)           (((a) < (b)) ? (a) : (b))       /* Take the minimum value */
+#define max(a, b)           (((a) > (b)) ? (a) : (b))       /* Take the maximum value */
+
+/**
+ * @brief Chip type names
+ */
+const char *const AT24Cxx_Trace_ChipName[12] =
+{
+    "AT24C01", "AT24C02", "AT24C04", "AT24C08", "AT24C16", "AT24C32",
+    "AT24C64", "AT24C128", "AT24C256", "AT24C512", "AT24CM01", "AT24CM02"
+};
+
+/**
+ * @brief Layer combinations : name, write cycle model, coalescing, cache, defer, lazy
+ * The lazy write cycle is polled by the driver itself, the bus adds no wait.
+ */
+const AT24Cxx_RUN_t AT24Cxx_Trace_Runs[AT24Cxx_TRACE_RUNS] =
+{
+    { "fixed",            AT24Cxx_SIM_WAIT_FIXED,   { 0, 0, 0, 0 } },
+    { "ackpoll",          AT24Cxx_SIM_WAIT_ACKPOLL, { 0, 0, 0, 0 } },
+    { "fixed+coalesce",   AT24Cxx_SIM_WAIT_FIXED,   { 1, 0, 0, 0 } },
+    { "ackpoll+coalesce", AT24Cxx_SIM_WAIT_ACKPOLL, { 1, 0, 0, 0 } },
+    { "ackpoll+cache",    AT24Cxx_SIM_WAIT_ACKPOLL, { 0, 1, 0, 0 } },
+    { "ackpoll+defer",    AT24Cxx_SIM_WAIT_ACKPOLL, { 0, 0, 1, 0 } },
+    { "ackpoll+lazy",     AT24Cxx_SIM_WAIT_NONE,    { 0, 0, 0, 1 } },
+};
+
+/**
+ * @brief  Look up a chip type by name
+ * @param  {const char} *name     : chip name (case insensitive, e.g. "AT24C256")
+ * @param  {AT24Cxx_CHIP} *type   : chip type
+ * @return {uint8_t}              : 0 --- found
+ *                                  1 --- unknown name, type unchanged
+ */
+uint8_t AT24Cxx_Trace_Chip(const char *name, AT24Cxx_CHIP *type)
+{
+    uint8_t i;
+
+    for (i = 0; i < 12; i++)
+    {
+        if (strcasecmp(name, AT24Cxx_Trace_ChipName[i]) == 0)
+        {
+            *type = (AT24Cxx_CHIP)(AT24C01 + i);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief  Load trace file
+ * @param  {const char} *path     : trace file, "-" --- standard input
+ * @param  {AT24Cxx_TRACE_t} **ops : operations (malloc, caller frees)
+ * @param  {uint32_t} *num         : number of operations
+ * @return {uint8_t}               : 0 --- success
+ *                                   1 --- error
+ */
+uint8_t AT24Cxx_Trace_Load(const char *path, AT24Cxx_TRACE_t **ops, uint32_t *num)
+{
+    FILE *fp;
+    char line[128], op;
+    long v[3];
+    uint32_t cap = 0, n = 0, lineno = 0;
+    AT24Cxx_TRACE_t *p = NULL, *q;
+    int k;
+
+    fp = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    if (fp == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        lineno++;
+
+        k = sscanf(line, " %c %li %li %li", &op, &v[0], &v[1], &v[2]);
+        if (k <= 0 || op == '#') continue;
+
+        if (!((op == 'R' && k == 3) || (op == 'W' && k == 3) || (op == 'E' && k >= 3) || (op == 'D' && k == 2)))
+        {
+            fprintf(stderr, "%s:%u: bad trace line\n", path, lineno);
+            free(p);
+            if (fp != stdin) fclose(fp);
+            return 1;
+        }
+
+        if (n == cap)
+        {
+            cap = cap ? cap * 2 : 1024;
+            q = (AT24Cxx_TRACE_t *)realloc(p, cap * sizeof(*p));
+            if (q == NULL)
+            {
+                free(p);
+                if (fp != stdin) fclose(fp);
+                return 1;
+            }
+            p = q;
+        }
+
+        p[n].op = op;
+        if (op == 'D')
+        {
+            p[n].addr = 0;
+            p[n].size = 0;
+            p[n].arg = (uint32_t)v[0];
+        }
+        else
+        {
+            p[n].addr = (uint32_t)v[0];
+            p[n].size = (uint32_t)v[1];
+            p[n].arg = (op == 'E' && k == 4) ? (uint32_t)v[2] & 0xFF : 0xFF;
+        }
+        n++;
+    }
+
+    if (fp != stdin) fclose(fp);
+
+    *ops = p;
+    *num = n;
+
+    return 0;
+}
+/**
+ * @brief  Attach the driver layers to a configured device
+ * @param  {at24cxx_t} *dev            : device (after AT24Cxx_config)
+ * @param  {const AT24Cxx_LAYER_t} *layer : layers
+ * @return {uint8_t}                   : 0 --- success
+ *                                       1 --- error (arena exhausted)
+ *                                       2 --- layer not built
+ * @note   The lazy write cycle is finished by acknowledge polling, so it also needs
+ *         AT24Cxx_TIMEOUT_MS. Each call takes new buffers from the driver arena.
+ */
+uint8_t AT24Cxx_Trace_Attach(at24cxx_t *dev, const AT24Cxx_LAYER_t *layer)
+{
+    uint8_t rsp = 0;
+
+    if (layer->cache)
+    {
+#if AT24Cxx_CACHE_SETS != 0
+        rsp |= AT24Cxx_Cache_Init(dev);
+#else
+        return 2;
+#endif
+    }
+    if (layer->defer)
+    {
+#if AT24Cxx_DEFER_PAGES != 0
+        rsp |= AT24Cxx_Defer_Init(dev);
+#else
+        return 2;
+#endif
+    }
+    if (layer->lazy)
+    {
+#if AT24Cxx_LAZY_WCYCLE != 0 && AT24Cxx_TIMEOUT_MS != 0
+        rsp |= AT24Cxx_Lazy_Init(dev);
+#else
+        return 2;
+#endif
+    }
+    (void)dev;
+
+    return rsp;
+}
+/**
+ * @brief  Program the deferred writes and finish the lazy write cycle
+ * @param  {at24cxx_t} *dev : device
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ */
+uint8_t AT24Cxx_Trace_Sync(at24cxx_t *dev)
+{
+    uint8_t rsp = 0;
+
+#if AT24Cxx_DEFER_PAGES != 0
+    if (dev->defer != NULL) rsp |= AT24Cxx_Defer_Flush(dev);
+#endif
+#if AT24Cxx_LAZY_WCYCLE != 0
+    if (dev->pend != NULL) rsp |= AT24Cxx_Lazy_Sync(dev);
+#endif
+    (void)dev;
+
+    return rsp ? 1 : 0;
+}
+/**
+ * @brief  Flush the coalescing window
+ * @param  {at24cxx_t} *dev : device
+ * @param  {uint8_t} *img   : expected memory image
+ * @param  {uint32_t} *lo   : window start
+ * @param  {uint32_t} *hi   : window end (lo == hi --- empty)
+ * @return {uint8_t}        : 0 --- success
+ *                            1 --- error
+ */
+static uint8_t AT24Cxx_Trace_Flush(at24cxx_t *dev, uint8_t *img, uint32_t *lo, uint32_t *hi)
+{
+    uint8_t rsp = 0;
+
+    if (*hi > *lo) rsp = AT24Cxx_Write(dev, *lo, img + *lo, *hi - *lo);
+    *lo = *hi = 0;
+
+    return rsp;
+}
+/**
+ * @brief  Replay trace through the driver
+ * @param  {at24cxx_t} *dev            : device
+ * @param  {const AT24Cxx_TRACE_t} *ops : operations
+ * @param  {uint32_t} num              : number of operations
+ * @param  {const AT24Cxx_LAYER_t} *layer : layers
+ * @param  {uint8_t} *img              : expected memory image (capacity bytes), updated
+ * @param  {void} (*idle)(uint32_t)    : idle time handler (us), NULL --- none
+ * @return {uint8_t}                   : 0 --- success
+ *                                       1 --- error
+ * @note   Written data is derived from a running counter so every write changes memory.
+ *         Operations out of the memory range are skipped. Idle time flushes the
+ *         coalescing window and the deferred writes before it is passed to the
+ *         idle handler, a lazy write cycle runs out during the idle time.
+ *         Attach the driver layers with AT24Cxx_Trace_Attach first.
+ */
+uint8_t AT24Cxx_Trace_Replay(at24cxx_t *dev, const AT24Cxx_TRACE_t *ops, uint32_t num, const AT24Cxx_LAYER_t *layer, uint8_t *img, void (*idle)(uint32_t))
+{
+    static uint8_t buf[65536];
+    uint32_t cap = AT24Cxx_CAPACITY(dev->info.type);
+    uint32_t i, j, lo = 0, hi = 0, seq = 0;
+    uint8_t rsp = 0;
+
+    for (i = 0; i < num; i++)
+    {
+        const AT24Cxx_TRACE_t *t = &ops[i];
+
+        if (t->op == 'D')
+        {
+            rsp |= AT24Cxx_Trace_Flush(dev, img, &lo, &hi);
+#if AT24Cxx_DEFER_PAGES != 0
+            if (dev->defer != NULL) rsp |= AT24Cxx_Defer_Flush(dev);
+#endif
+            if (idle != NULL) idle(t->arg);
+            continue;
+        }
+        if (t->size == 0 || t->addr >= cap || t->size > cap - t->addr) continue;
+
+        switch (t->op)
+        {
+            case 'R': {
+                /* Reads see the coalesced data in RAM */
+                if (t->addr < hi && t->addr + t->size > lo) rsp |= AT24Cxx_Trace_Flush(dev, img, &lo, &hi);
+                for (j = 0; j < t->size; j += sizeof(buf))
+                {
+                    rsp |= AT24Cxx_Read(dev, t->addr + j, buf, min(sizeof(buf), t->size - j));
+                }
+                break;}
+            case 'W':
+            case 'E': {
+                for (j = 0; j < t->size; j++)
+                {
+                    img[t->addr + j] = (t->op == 'W') ? (uint8_t)(seq++ * 7 + 1) : (uint8_t)t->arg;
+                }
+
+                if (layer->coalesce == 0)
+                {
+                    rsp |= (t->op == 'W') ? AT24Cxx_Write(dev, t->addr, img + t->addr, t->size) : AT24Cxx_Erase(dev, t->addr, (uint8_t)t->arg, t->size);
+                    break;
+                }
+
+                /* Extend the window when the range touches it and fits */
+                if (hi > lo && t->addr <= hi && t->addr + t->size >= lo && max(hi, t->addr + t->size) - min(lo, t->addr) <= layer->coalesce)
+                {
+                    lo = min(lo, t->addr);
+                    hi = max(hi, t->addr + t->size);
+                    break;
+                }
+
+                rsp |= AT24Cxx_Trace_Flush(dev, img, &lo, &hi);
+                if (t->size <= layer->coalesce)
+                {
+                    lo = t->addr;
+                    hi = t->addr + t->size;
+                }
+                else
+                {
+                    rsp |= AT24Cxx_Write(dev, t->addr, img + t->addr, t->size);
+                }
+                break;}
+            default: break;
+        }
+    }
+
+    rsp |= AT24Cxx_Trace_Flush(dev, img, &lo, &hi);
+    rsp |= AT24Cxx_Trace_Sync(dev);
+
+    return rsp;
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2023 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    AT24Cxx_trace.h
+ * @brief   Workload trace parser and replay, shared tool tables header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   18-10-2026        iammingge                Initial Version 1.0
+ *
+ * Trace format, one operation per line (numbers in C notation, '#' comments) :
+ *   R <addr> <size>           read
+ *   W <addr> <size>           write
+ *   E <addr> <size> [fill]    erase (fill defaults to 0xFF)
+ *   D <us>                    idle time
+**/
+#ifndef __AT24CXX_TRACE_H
+#define __AT24CXX_TRACE_H
+#include "AT24Cxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Trace operation
+ */
+typedef struct
+{
+    char op;                        /* 'R', 'W', 'E', 'D' */
+    uint32_t addr;
+    uint32_t size;
+    uint32_t arg;                   /* fill data of 'E', idle time (us) of 'D' */
+} AT24Cxx_TRACE_t;
+
+/**
+ * @brief Layers between the workload and the driver
+ */
+typedef struct
+{
+    uint32_t coalesce;              /* write coalescing window (bytes), 0 --- off */
+    uint8_t cache;                  /* page cache, AT24Cxx_Cache_Init (AT24Cxx_CACHE_SETS) */
+    uint8_t defer;                  /* deferred writes, AT24Cxx_Defer_Init (AT24Cxx_DEFER_PAGES) */
+    uint8_t lazy;                   /* lazy write cycle, AT24Cxx_Lazy_Init (AT24Cxx_LAZY_WCYCLE and AT24Cxx_TIMEOUT_MS) */
+} AT24Cxx_LAYER_t;
+
+/**
+ * @brief Layer combination of the what-if tools
+ * layer.coalesce only enables coalescing, the tool sets its window.
+ */
+typedef struct
+{
+    const char *name;
+    uint8_t wait;                   /* AT24Cxx_SIM_WAIT_xxx */
+    AT24Cxx_LAYER_t layer;
+} AT24Cxx_RUN_t;
+
+/**
+ * @brief Number of layer combinations
+ */
+#define AT24Cxx_TRACE_RUNS          7
+
+extern const char *const AT24Cxx_Trace_ChipName[12];   /* indexed by type - AT24C01 */
+extern const AT24Cxx_RUN_t AT24Cxx_Trace_Runs[AT24Cxx_TRACE_RUNS];
+
+uint8_t AT24Cxx_Trace_Chip(const char *name, AT24Cxx_CHIP *type);
+uint8_t AT24Cxx_Trace_Load(const char *path, AT24Cxx_TRACE_t **ops, uint32_t *num);
+uint8_t AT24Cxx_Trace_Attach(at24cxx_t *dev, const AT24Cxx_LAYER_t *layer);
+uint8_t AT24Cxx_Trace_Sync(at24cxx_t *dev);
+uint8_t AT24Cxx_Trace_Replay(at24cxx_t *dev, const AT24Cxx_TRACE_t *ops, uint32_t num, const AT24Cxx_LAYER_t *layer, uint8_t *img, void (*idle)(uint32_t));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif